@@ -0,0 +1,202 @@
+#include "job_system.h"
+#include <algorithm>
+
+void JobGraph::clear() {
+    taskCount = 0;
+    jobTask.clear();
+}
+
+int JobGraph::add(int count, int grain, Work work, std::initializer_list<int> after) {
+    if (taskCount == static_cast<int>(tasks.size())) {
+        tasks.emplace_back();
+    }
+    Task& task = tasks[taskCount];
+    task.work = std::move(work);
+    task.count = std::max(count, 0);
+    task.grain = std::max(grain, 1);
+    task.firstJob = static_cast<int>(jobTask.size());
+    task.jobCount = std::max(1, (task.count + task.grain - 1) / task.grain);
+    jobTask.insert(jobTask.end(), task.jobCount, taskCount);
+
+    task.parents = 0;
+    task.dependents.clear();
+    for (int parent : after) {
+        if (parent < 0) continue;
+        tasks[parent].dependents.push_back(taskCount);
+        task.parents++;
+    }
+    return taskCount++;
+}
+
+void JobGraph::prepare() {
+    for (int t = 0; t < taskCount; ++t) {
+        tasks[t].jobsLeft.store(tasks[t].jobCount, std::memory_order_relaxed);
+        tasks[t].parentsLeft.store(tasks[t].parents, std::memory_order_relaxed);
+    }
+}
+
+// Chase-Lev deque of job ids in a fixed ring. The owner pushes and pops at the bottom, thieves
+// take from the top, and the only contended case, the last job, is settled by a compare-and-swap
+// on top. The bottom write in pop() and the top read after it must not be reordered, which
+// sequentially consistent operations guarantee on every platform.
+class JobSystem::WorkDeque {
+public:
+    WorkDeque() : top(0), bottom(0) {}
+
+    // Owner only. Returns false when full, and the caller runs the job itself.
+    bool push(int job) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= CAPACITY) return false;
+        jobs[b & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only, newest job first. Returns -1 if there is none.
+    int pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_seq_cst);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_release);
+            return -1;
+        }
+        int job = jobs[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last job: a thief may be taking it at the same time, and whoever moves top wins
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                job = -1;
+            }
+            bottom.store(b + 1, std::memory_order_release);
+        }
+        return job;
+    }
+
+    // Any other thread, oldest job first. Returns -1 if there is none or another thread took it.
+    int steal() {
+        int64_t t = top.load(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) return -1;
+        int job = jobs[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return -1;
+        }
+        return job;
+    }
+
+private:
+    static const int64_t CAPACITY = 4096; // A power of two
+
+    std::atomic<int64_t> top;
+    char topPadding[64 - sizeof(std::atomic<int64_t>)]; // Thieves hammer top, the owner bottom
+    std::atomic<int64_t> bottom;
+    char bottomPadding[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<int> jobs[CAPACITY];
+};
+
+JobSystem::JobSystem(int threads)
+    : threadCount(std::max(threads, 1)), counters(threadCount), current(nullptr), unfinished(0),
+    generation(0), stopping(false) {
+    for (int i = 0; i < threadCount; ++i) {
+        deques.emplace_back(new WorkDeque());
+    }
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::run(JobGraph& graph) {
+    if (graph.size() == 0) return;
+    graph.prepare();
+    current.store(&graph, std::memory_order_relaxed);
+    unfinished.store(graph.size(), std::memory_order_relaxed);
+    // The jobs are published by the deque's release, which also carries everything above
+    for (int task = 0; task < graph.size(); ++task) {
+        if (graph.tasks[task].parents == 0) {
+            schedule(graph, task, 0);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        generation++;
+    }
+    wake.notify_all();
+    help(0);
+}
+
+void JobSystem::workerLoop(int self) {
+    unsigned int seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        help(self);
+    }
+}
+
+// Works until the current graph is done. Threads that find nothing to do yield rather than
+// sleep, since another job usually turns up within microseconds when a task finishes.
+void JobSystem::help(int self) {
+    while (unfinished.load(std::memory_order_acquire) > 0) {
+        if (!runOne(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::runOne(int self) {
+    int job = deques[self]->pop();
+    if (job < 0) {
+        for (int k = 1; k < threadCount && job < 0; ++k) {
+            job = deques[(self + k) % threadCount]->steal();
+        }
+        if (job < 0) return false;
+        counters[self].stolen++;
+    }
+    execute(job, self);
+    return true;
+}
+
+// Whoever finishes a task's last job releases the tasks waiting on it. The unfinished count
+// drops last, after the graph is no longer touched, so run() may return and the caller may
+// rebuild the graph the moment it reaches zero.
+void JobSystem::execute(int job, int self) {
+    counters[self].jobs++;
+    JobGraph& graph = *current.load(std::memory_order_relaxed);
+    JobGraph::Task& task = graph.tasks[graph.jobTask[job]];
+    int begin = (job - task.firstJob) * task.grain;
+    task.work(begin, std::min(begin + task.grain, task.count));
+
+    if (task.jobsLeft.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    for (int dependent : task.dependents) {
+        if (graph.tasks[dependent].parentsLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            schedule(graph, dependent, self);
+        }
+    }
+    unfinished.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+// Pushed last job first, so the owner pops them in order and thieves take from the far end
+void JobSystem::schedule(JobGraph& graph, int task, int self) {
+    const JobGraph::Task& ready = graph.tasks[task];
+    for (int job = ready.firstJob + ready.jobCount - 1; job >= ready.firstJob; --job) {
+        if (!deques[self]->push(job)) {
+            execute(job, self);
+        }
+    }
+}
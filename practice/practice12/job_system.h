@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// One frame's work as a graph of tasks. A task runs work(begin, end) over [0, count) in chunks
+// of grain items, once every task it was added after has finished; each chunk is one job for
+// the JobSystem. Build the graph on one thread, then hand it to JobSystem::run(). clear() keeps
+// the storage, so rebuilding a graph of the same shape every frame allocates nothing once warm.
+class JobGraph {
+public:
+    typedef std::function<void(int, int)> Work;
+
+    JobGraph() : taskCount(0) {}
+
+    void clear();
+
+    // Adds a task and returns its id for later tasks to wait on. Ids in after that are negative
+    // are skipped, so a chain can start from "no task". A count of 0 still runs work(0, 0) once.
+    int add(int count, int grain, Work work, std::initializer_list<int> after = {});
+
+    int size() const { return taskCount; }
+
+private:
+    friend class JobSystem;
+
+    struct Task {
+        Work work;
+        int count;
+        int grain;
+        int firstJob;
+        int jobCount;
+        int parents;
+        std::vector<int> dependents;
+        std::atomic<int> jobsLeft; // Counted down while the graph runs
+        std::atomic<int> parentsLeft;
+    };
+
+    std::deque<Task> tasks; // Never shrinks: a deque keeps the atomics in place as it grows
+    int taskCount;
+    std::vector<int> jobTask; // Task of each job; a task's jobs are consecutive
+
+    // Resets the countdowns before a run
+    void prepare();
+};
+
+// Runs JobGraphs on a fixed set of threads. Every thread owns a work-stealing deque: it pushes
+// the jobs of tasks it unblocks onto its own deque and pops the newest first, while idle
+// threads steal the oldest from the others, so related work stays on one core until someone
+// is free to take it. Workers sleep between graphs, and the thread that calls run() works too.
+class JobSystem {
+public:
+    // threads counts the caller of run(), so threads - 1 workers are started
+    explicit JobSystem(int threads);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    int threads() const { return threadCount; }
+
+    // Runs every task of graph and returns once all of them have finished. One graph at a
+    // time, always from the same thread.
+    void run(JobGraph& graph);
+
+    // Jobs each thread ran since it started, and how many of those it stole; thread 0 is the
+    // one calling run(). Only read between runs.
+    long long jobsRun(int thread) const { return counters[thread].jobs; }
+    long long jobsStolen(int thread) const { return counters[thread].stolen; }
+
+private:
+    class WorkDeque;
+
+    // Written only by its own thread; padded so two threads never share a cache line
+    struct Counters {
+        long long jobs;
+        long long stolen;
+        char padding[64 - 2 * sizeof(long long)];
+    };
+
+    int threadCount;
+    std::vector<std::unique_ptr<WorkDeque>> deques;
+    std::vector<Counters> counters;
+    std::vector<std::thread> workers;
+
+    std::atomic<JobGraph*> current;
+    std::atomic<int> unfinished; // Tasks of the current graph not finished yet
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    unsigned int generation; // Bumped for every run, so sleeping workers know to start
+    bool stopping;
+
+    void workerLoop(int self);
+    void help(int self);
+    bool runOne(int self);
+    void execute(int job, int self);
+    void schedule(JobGraph& graph, int task, int self);
+};
@@ -1,22 +1,228 @@
 #define SDL_MAIN_HANDLED
 #include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "job_system.h"
+#include "spatial_hash.h"
+#include "sprites.h"
+
+const int WINDOW_WIDTH = 800;
+const int WINDOW_HEIGHT = 600;
+const double TICK = 1.0 / 120.0; // Simulation step in seconds, independent of the display rate
+const double MAX_FRAME_TIME = 0.25; // Longer stalls are dropped instead of simulated in one burst
+const int MAX_TICKS_PER_FRAME = 4; // More ticks than this is time the update cannot keep up with
+
+const int MAX_SPRITES = 1000000;
+const int SORT_INTERVAL = 16; // Ticks between putting colliding sprites back in cell order
+
+// Seconds between two performance counter readings
+double secondsBetween(Uint64 start, Uint64 end) {
+    return static_cast<double>(end - start) / static_cast<double>(SDL_GetPerformanceFrequency());
+}
+
+// Sprites per job: about four jobs per thread, so a thread that falls behind has work left to
+// steal, but never so few sprites that handing out the job costs more than doing it. A
+// multiple of four, as SpriteField::step() needs.
+int jobGrain(int spriteCount, int threads) {
+    int grain = std::max(spriteCount / (threads * 4), 2048);
+    return (grain + 3) & ~3;
+}
+
+// Everything a frame's jobs work on
+struct Scene {
+    SpriteField sprites;
+    SpatialHash grid;
+    std::vector<SDL_FRect> rects;
+    bool collide;
+    long long collisionTicks;
+
+    // Sprites are spriteSize px squares. The grid's cells are the size of a sprite.
+    Scene(int spriteCount, bool collide, float spriteSize)
+        : sprites(spriteCount, spriteSize, WINDOW_WIDTH, WINDOW_HEIGHT, 12345u),
+        grid(collide ? spriteCount : 0, WINDOW_WIDTH, WINDOW_HEIGHT, spriteSize),
+        rects(spriteCount), collide(collide), collisionTicks(0) {
+        if (spriteCount == 1) {
+            sprites.place(0, 100.0f, 100.0f, 240.0f, 180.0f); // The old 4 and 3 px per 16 ms frame
+        }
+    }
+
+    // One sprite is the original demo's rectangle; a crowd gets 4 px squares, colliding or not
+    static float defaultSpriteSize(int spriteCount) {
+        return spriteCount == 1 ? 50.0f : 4.0f;
+    }
+};
+
+// Plans one frame on graph: ticks fixed steps, then the rectangles to draw, alpha of the way
+// into the next tick. Without collisions every sprite moves on its own, so each job runs all
+// the frame's ticks for its chunk of sprites with no waiting in between. With them, every tick
+// integrates, buckets the sprites, finds each sprite's corrections and applies them, and each
+// stage waits for the whole of the one before, since a sprite's contacts can be anywhere.
+void planFrame(JobGraph& graph, Scene& scene, int ticks, float alpha, int grain) {
+    int count = scene.sprites.size();
+    float dt = static_cast<float>(TICK);
+    graph.clear();
+    int last = -1;
+    if (!scene.collide) {
+        if (ticks > 0) {
+            last = graph.add(count, grain, [&scene, ticks, dt](int begin, int end) {
+                for (int t = 0; t < ticks; ++t) scene.sprites.step(dt, begin, end);
+            });
+        }
+    }
+    else {
+        for (int t = 0; t < ticks; ++t) {
+            last = graph.add(count, grain, [&scene, dt](int begin, int end) { scene.sprites.step(dt, begin, end); }, { last });
+            last = graph.add(1, 1, [&scene, count](int, int) {
+                scene.grid.build(scene.sprites.positionsX(), scene.sprites.positionsY(), count);
+            }, { last });
+            last = graph.add(count, grain, [&scene](int begin, int end) { scene.sprites.collide(scene.grid, begin, end); }, { last });
+            last = graph.add(count, grain, [&scene](int begin, int end) { scene.sprites.applyCollisions(begin, end); }, { last });
+            if (++scene.collisionTicks % SORT_INTERVAL == 0) {
+                last = graph.add(1, 1, [&scene](int, int) { scene.sprites.sortByCell(scene.grid); }, { last });
+            }
+        }
+    }
+    graph.add(count, grain, [&scene, alpha](int begin, int end) {
+        scene.sprites.interpolate(alpha, scene.rects.data(), begin, end);
+    }, { last });
+}
+
+// "practice12 --scaling": times the same frames, two ticks each, on 1, 2, 4 ... threads up to
+// every hardware thread, without opening a window, and prints each time per frame with its
+// speedup over one thread
+void runScaling(int spriteCount, bool collide, float spriteSize) {
+    const int FRAMES = 240;
+    int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    double oneThread = 0.0;
+    for (int threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+        Scene scene(spriteCount, collide, spriteSize);
+        JobSystem jobs(threads);
+        JobGraph graph;
+        int grain = jobGrain(spriteCount, threads);
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int frame = 0; frame < FRAMES; ++frame) {
+            planFrame(graph, scene, 2, 0.5f, grain);
+            jobs.run(graph);
+        }
+        double frameTime = 1000.0 * secondsBetween(start, SDL_GetPerformanceCounter()) / FRAMES;
+        if (threads == 1) oneThread = frameTime;
+        std::printf("%d sprites%s, %2d threads: %.3f ms/frame  %.2fx\n", spriteCount, collide ? " colliding" : "",
+            threads, frameTime, oneThread / frameTime);
+        if (threads == maxThreads) break;
+    }
+}
+
+// Frame-to-frame times, summarized with percentiles and a 1 ms histogram when the demo exits
+void printFrameTimes(std::vector<float>& frameTimes) {
+    if (frameTimes.empty()) return;
+    std::sort(frameTimes.begin(), frameTimes.end());
+    double total = 0.0;
+    for (float t : frameTimes) total += t;
+    auto percentile = [&frameTimes](double p) { return frameTimes[static_cast<size_t>(p * (frameTimes.size() - 1))]; };
+
+    std::printf("%zu frames, mean %.2f ms (%.1f fps)  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms\n",
+        frameTimes.size(), total / frameTimes.size(), 1000.0 * frameTimes.size() / total,
+        percentile(0.50), percentile(0.95), percentile(0.99), frameTimes.back());
+
+    const int BUCKETS = 50; // 0-1 ms ... 49-50 ms, then everything slower
+    int counts[BUCKETS + 1] = {};
+    for (float t : frameTimes) {
+        counts[std::min(static_cast<int>(t), BUCKETS)]++;
+    }
+    int tallest = *std::max_element(counts, counts + BUCKETS + 1);
+    for (int i = 0; i <= BUCKETS; ++i) {
+        if (counts[i] == 0) continue;
+        std::string bar(static_cast<size_t>(60.0 * counts[i] / tallest + 0.5), '#');
+        if (i < BUCKETS) {
+            std::printf("%3d-%-3d ms %8d %s\n", i, i + 1, counts[i], bar.c_str());
+        }
+        else {
+            std::printf("   >%-3d ms %8d %s\n", BUCKETS, counts[i], bar.c_str());
+        }
+    }
+}
+
+// "practice12 [--sprites n] [--size px] [--collide] [--threads n] [--no-vsync] [--scaling]":
+// without vsync frames are presented as fast as the renderer allows. With --sprites the demo
+// becomes a stress test of n small rectangles (up to 1,000,000, 4 px unless --size says
+// otherwise) and prints sprite updates per second, job and draw time per frame once a second.
+// --collide makes the rectangles bounce off each other as well. The sprite work runs as jobs on
+// --threads threads (every hardware thread by default).
+int main(int argc, char* argv[]) {
+    bool vsync = true;
+    bool collide = false;
+    bool scaling = false;
+    int spriteCount = 1;
+    float spriteSize = 0.0f; // 0 until --size picks one
+    int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--no-vsync") == 0) {
+            vsync = false;
+        }
+        else if (std::strcmp(argv[i], "--sprites") == 0 && i + 1 < argc) {
+            spriteCount = std::min(std::max(std::atoi(argv[++i]), 1), MAX_SPRITES);
+        }
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            spriteSize = static_cast<float>(std::min(std::max(std::atoi(argv[++i]), 1), 100));
+        }
+        else if (std::strcmp(argv[i], "--collide") == 0) {
+            collide = true;
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::max(std::atoi(argv[++i]), 1);
+        }
+        else if (std::strcmp(argv[i], "--scaling") == 0) {
+            scaling = true;
+        }
+        else {
+            std::cerr << "Usage: practice12 [--sprites n] [--size px] [--collide] [--threads n] [--no-vsync] [--scaling]" << std::endl;
+            return 1;
+        }
+    }
+    if (spriteSize == 0.0f) {
+        spriteSize = Scene::defaultSpriteSize(spriteCount);
+    }
+    if (scaling) {
+        runScaling(spriteCount, collide, spriteSize);
+        return 0;
+    }
 
-int main() {
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
         return 1;
     }
 
     SDL_Window* window = SDL_CreateWindow("Bouncing Rectangle",
-        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, 0);
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, 0);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1,
+        SDL_RENDERER_ACCELERATED | (vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
 
-    SDL_Rect rect = { 100, 100, 50, 50 };
-    int dx = 4, dy = 3;
+    Scene scene(spriteCount, collide, spriteSize);
+    JobSystem jobs(threads);
+    JobGraph graph;
+    int grain = jobGrain(spriteCount, threads);
 
     bool running = true;
     SDL_Event e;
+    std::vector<float> frameTimes; // Milliseconds
+    frameTimes.reserve(1 << 16);
+    Uint64 lastCounter = SDL_GetPerformanceCounter();
+    double accumulator = 0.0;
+    long long droppedTicks = 0;
+
+    // Totals for the whole run, and for the one-second report in stress mode
+    double updateSeconds = 0.0, drawSeconds = 0.0;
+    long long updates = 0, frames = 0;
+    double reportUpdateSeconds = 0.0, reportDrawSeconds = 0.0;
+    long long reportUpdates = 0, reportFrames = 0;
+    Uint64 reportStart = lastCounter;
 
     while (running) {
         while (SDL_PollEvent(&e)) {
@@ -26,24 +232,83 @@ int main() {
                 running = false;
         }
 
-        rect.x += dx;
-        rect.y += dy;
+        Uint64 counter = SDL_GetPerformanceCounter();
+        double frameTime = secondsBetween(lastCounter, counter);
+        lastCounter = counter;
+        frameTimes.push_back(static_cast<float>(frameTime * 1000.0));
 
-        if (rect.x < 0 || rect.x + rect.w > 800) dx *= -1;
-        if (rect.y < 0 || rect.y + rect.h > 600) dy *= -1;
+        // Run as many fixed ticks as real time has passed; the remainder carries to the next
+        // frame, and the sprites are drawn between the last two ticks by how far real time is
+        // into the next one. run() is the frame's barrier: it returns once every sprite has
+        // moved and every rectangle is written, so the draw below sees a finished frame.
+        accumulator += std::min(frameTime, MAX_FRAME_TIME);
+        int ticks = 0;
+        while (accumulator >= TICK && ticks < MAX_TICKS_PER_FRAME) {
+            accumulator -= TICK;
+            ticks++;
+        }
+        // When the update is slower than real time, catching up would only make the next frame
+        // longer still, so the surplus whole ticks are dropped and the simulation slows down
+        if (accumulator >= TICK) {
+            droppedTicks += static_cast<long long>(accumulator / TICK);
+            accumulator = std::fmod(accumulator, TICK);
+        }
+        Uint64 updateStart = SDL_GetPerformanceCounter();
+        planFrame(graph, scene, ticks, static_cast<float>(accumulator / TICK), grain);
+        jobs.run(graph);
+        double updateTime = secondsBetween(updateStart, SDL_GetPerformanceCounter());
 
+        // Every sprite goes to the renderer in one batched call; the flush makes the draw time
+        // include the backend's work, which would otherwise be deferred to the present.
+        Uint64 drawStart = SDL_GetPerformanceCounter();
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // black background
         SDL_RenderClear(renderer);
 
-        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); // red rectangle
-        SDL_RenderFillRect(renderer, &rect);
+        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); // red rectangles
+        SDL_RenderFillRectsF(renderer, scene.rects.data(), spriteCount);
+        SDL_RenderFlush(renderer);
+        double drawTime = secondsBetween(drawStart, SDL_GetPerformanceCounter());
+
+        SDL_RenderPresent(renderer); // Paced by vsync instead of a fixed sleep
 
-        SDL_RenderPresent(renderer);
-        SDL_Delay(16); // ~60 FPS
+        updateSeconds += updateTime;
+        drawSeconds += drawTime;
+        updates += static_cast<long long>(ticks) * spriteCount;
+        frames++;
+        reportUpdateSeconds += updateTime;
+        reportDrawSeconds += drawTime;
+        reportUpdates += static_cast<long long>(ticks) * spriteCount;
+        reportFrames++;
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (spriteCount > 1 && secondsBetween(reportStart, now) >= 1.0) {
+            std::printf("%d sprites: %.1f M updates/s  jobs %.2f ms/frame  draw %.2f ms/frame  %.1f fps\n", spriteCount,
+                reportUpdateSeconds > 0.0 ? reportUpdates / reportUpdateSeconds / 1e6 : 0.0,
+                1000.0 * reportUpdateSeconds / reportFrames, 1000.0 * reportDrawSeconds / reportFrames,
+                reportFrames / secondsBetween(reportStart, now));
+            reportUpdateSeconds = reportDrawSeconds = 0.0;
+            reportUpdates = reportFrames = 0;
+            reportStart = now;
+        }
+    }
+
+    frameTimes.erase(frameTimes.begin()); // The first frame measures startup, not pacing
+    printFrameTimes(frameTimes);
+    if (frames > 0) {
+        std::printf("%d sprites: %.1f M updates/s while updating, jobs %.3f ms/frame, draw %.3f ms/frame\n", spriteCount,
+            updateSeconds > 0.0 ? updates / updateSeconds / 1e6 : 0.0, 1000.0 * updateSeconds / frames,
+            1000.0 * drawSeconds / frames);
+    }
+    if (droppedTicks > 0) {
+        std::printf("%lld ticks dropped: the update could not keep up with real time\n", droppedTicks);
+    }
+    if (spriteCount > 1) {
+        for (int t = 0; t < jobs.threads(); ++t) {
+            std::printf("thread %d: %lld jobs, %lld stolen\n", t, jobs.jobsRun(t), jobs.jobsStolen(t));
+        }
     }
 
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,41 @@
+#include "spatial_hash.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(int capacity, float width, float height, float cellSize)
+    : columnCount(std::max(1, static_cast<int>(std::ceil(width / cellSize)))),
+    rowCount(std::max(1, static_cast<int>(std::ceil(height / cellSize)))),
+    inverseCellSize(1.0f / cellSize),
+    cellStart(static_cast<size_t>(columnCount) * rowCount + 1), spriteCell(capacity), sortedIds(capacity),
+    sortedX(capacity), sortedY(capacity) {
+}
+
+int SpatialHash::columnOf(float x) const {
+    return std::min(std::max(static_cast<int>(x * inverseCellSize), 0), columnCount - 1);
+}
+
+int SpatialHash::rowOf(float y) const {
+    return std::min(std::max(static_cast<int>(y * inverseCellSize), 0), rowCount - 1);
+}
+
+// Counting sort: count the sprites per cell, turn the counts into running end offsets, then
+// place each sprite by decrementing its cell's end, which leaves every entry at its cell's start
+void SpatialHash::build(const float* x, const float* y, int count) {
+    int cells = columnCount * rowCount;
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (int i = 0; i < count; ++i) {
+        int cell = cellOf(x[i], y[i]);
+        spriteCell[i] = cell;
+        cellStart[cell]++;
+    }
+    for (int cell = 1; cell < cells; ++cell) {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+    for (int i = count - 1; i >= 0; --i) {
+        int slot = --cellStart[spriteCell[i]];
+        sortedIds[slot] = i;
+        sortedX[slot] = x[i];
+        sortedY[slot] = y[i];
+    }
+    cellStart[cells] = count;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+// A uniform grid over the sprite box that buckets sprites by the cell holding their top-left
+// corner. Rebuilt every tick with a counting sort into arrays sized once up front, so a
+// rebuild is two linear passes over the sprites and allocates nothing. With cells at least as
+// large as a sprite, two sprites can only overlap if their cells are neighbors, so a query
+// looks at 3x3 cells instead of every other sprite. Positions are copied out in cell order
+// too: cells next to each other in a row are next to each other in memory, so a query reads
+// three short runs instead of chasing ids across the whole sprite array.
+class SpatialHash {
+public:
+    SpatialHash(int capacity, float width, float height, float cellSize);
+
+    // Buckets sprites [0, count) by position; count must not exceed the capacity
+    void build(const float* x, const float* y, int count);
+
+    int columns() const { return columnCount; }
+    int rows() const { return rowCount; }
+    int columnOf(float x) const;
+    int rowOf(float y) const;
+    int cellOf(float x, float y) const { return rowOf(y) * columnCount + columnOf(x); }
+
+    // Sprites in cell c = row * columns() + column are slots [cellBegin(c), cellEnd(c)): sprite
+    // ids()[slot], at (slotX()[slot], slotY()[slot]) when the grid was built
+    int cellBegin(int cell) const { return cellStart[cell]; }
+    int cellEnd(int cell) const { return cellStart[cell + 1]; }
+    int size() const { return cellStart.back(); }
+    const int* ids() const { return sortedIds.data(); }
+    const float* slotX() const { return sortedX.data(); }
+    const float* slotY() const { return sortedY.data(); }
+
+private:
+    int columnCount;
+    int rowCount;
+    float inverseCellSize;
+    std::vector<int> cellStart; // One entry per cell plus an end marker
+    std::vector<int> spriteCell; // Cell of each sprite, kept between the two sort passes
+    std::vector<int> sortedIds; // Sprite ids grouped by cell
+    std::vector<float> sortedX, sortedY;
+};
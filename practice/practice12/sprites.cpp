@@ -0,0 +1,200 @@
+#include "sprites.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPRITES_SSE2 1
+#endif
+
+namespace {
+    int paddedCount(int count) {
+        return (count + 3) & ~3;
+    }
+
+    float randomUnit(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(state & 0xFFFFFF) / static_cast<float>(0xFFFFFF);
+    }
+}
+
+SpriteField::SpriteField(int count, float size, float width, float height, uint32_t seed)
+    : count(count), side(size), maxX(width - size), maxY(height - size),
+    x(paddedCount(count)), y(paddedCount(count)), previousX(paddedCount(count)), previousY(paddedCount(count)),
+    velocityX(paddedCount(count)), velocityY(paddedCount(count)),
+    pushX(count), pushY(count), bounceX(count), bounceY(count), partnerX(count), partnerY(count), scratch(paddedCount(count)) {
+    // Random positions and speeds of 60 to 240 pixels per second in a random direction
+    uint32_t state = seed ? seed : 1;
+    for (int i = 0; i < count; ++i) {
+        float speed = 60.0f + 180.0f * randomUnit(state);
+        float angle = 6.2831853f * randomUnit(state);
+        place(i, maxX * randomUnit(state), maxY * randomUnit(state), speed * std::cos(angle), speed * std::sin(angle));
+    }
+}
+
+void SpriteField::place(int i, float newX, float newY, float newVelocityX, float newVelocityY) {
+    x[i] = previousX[i] = newX;
+    y[i] = previousY[i] = newY;
+    velocityX[i] = newVelocityX;
+    velocityY[i] = newVelocityY;
+}
+
+// Moves, then reflects the velocity of every sprite that left the box and clamps it back in,
+// with no branches: the out-of-bounds test becomes a mask that selects the flipped velocity.
+void SpriteField::step(float dt, int begin, int end) {
+    end = std::min(paddedCount(end), static_cast<int>(x.size()));
+    int i = begin;
+#ifdef SPRITES_SSE2
+    const __m128 step = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 limitX = _mm_set1_ps(maxX);
+    const __m128 limitY = _mm_set1_ps(maxY);
+    for (; i + 4 <= end; i += 4) {
+        __m128 px = _mm_loadu_ps(&x[i]);
+        __m128 py = _mm_loadu_ps(&y[i]);
+        __m128 vx = _mm_loadu_ps(&velocityX[i]);
+        __m128 vy = _mm_loadu_ps(&velocityY[i]);
+        _mm_storeu_ps(&previousX[i], px);
+        _mm_storeu_ps(&previousY[i], py);
+
+        px = _mm_add_ps(px, _mm_mul_ps(vx, step));
+        py = _mm_add_ps(py, _mm_mul_ps(vy, step));
+        __m128 outX = _mm_or_ps(_mm_cmplt_ps(px, zero), _mm_cmpgt_ps(px, limitX));
+        __m128 outY = _mm_or_ps(_mm_cmplt_ps(py, zero), _mm_cmpgt_ps(py, limitY));
+        vx = _mm_xor_ps(vx, _mm_and_ps(outX, signBit));
+        vy = _mm_xor_ps(vy, _mm_and_ps(outY, signBit));
+        px = _mm_min_ps(_mm_max_ps(px, zero), limitX);
+        py = _mm_min_ps(_mm_max_ps(py, zero), limitY);
+
+        _mm_storeu_ps(&x[i], px);
+        _mm_storeu_ps(&y[i], py);
+        _mm_storeu_ps(&velocityX[i], vx);
+        _mm_storeu_ps(&velocityY[i], vy);
+    }
+#endif
+    for (; i < end; ++i) {
+        previousX[i] = x[i];
+        previousY[i] = y[i];
+        x[i] += velocityX[i] * dt;
+        y[i] += velocityY[i] * dt;
+        if (x[i] < 0.0f || x[i] > maxX) velocityX[i] = -velocityX[i];
+        if (y[i] < 0.0f || y[i] > maxY) velocityY[i] = -velocityY[i];
+        x[i] = std::min(std::max(x[i], 0.0f), maxX);
+        y[i] = std::min(std::max(y[i], 0.0f), maxY);
+    }
+}
+
+void SpriteField::interpolate(float alpha, SDL_FRect* rects, int begin, int end) const {
+    int i = begin;
+#ifdef SPRITES_SSE2
+    const __m128 blend = _mm_set1_ps(alpha);
+    const __m128 sizes = _mm_set1_ps(side);
+    for (; i + 4 <= end; i += 4) {
+        __m128 fromX = _mm_loadu_ps(&previousX[i]);
+        __m128 fromY = _mm_loadu_ps(&previousY[i]);
+        __m128 px = _mm_add_ps(fromX, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&x[i]), fromX), blend));
+        __m128 py = _mm_add_ps(fromY, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&y[i]), fromY), blend));
+        __m128 pw = sizes;
+        __m128 ph = sizes;
+        _MM_TRANSPOSE4_PS(px, py, pw, ph); // Four x, y, w, h rows become four SDL_FRects
+        float* out = &rects[i].x;
+        _mm_storeu_ps(out, px);
+        _mm_storeu_ps(out + 4, py);
+        _mm_storeu_ps(out + 8, pw);
+        _mm_storeu_ps(out + 12, ph);
+    }
+#endif
+    for (; i < end; ++i) {
+        rects[i] = { previousX[i] + (x[i] - previousX[i]) * alpha, previousY[i] + (y[i] - previousY[i]) * alpha, side, side };
+    }
+}
+
+// Each sprite sums its own push-out from every sprite it overlaps, half the overlap since the
+// other sprite moves the other half, and averages the velocity it takes from those it is
+// moving into; averaging keeps a sprite wedged between several from gaining speed.
+// Jacobi-style: every sprite is corrected from the others' positions and velocities at the start
+// of the pass, so the result does not depend on the order sprites are visited in
+void SpriteField::collide(const SpatialHash& grid, int begin, int end) {
+    const int* ids = grid.ids();
+    const float* slotX = grid.slotX();
+    const float* slotY = grid.slotY();
+    for (int slot = begin; slot < end; ++slot) {
+        int i = ids[slot];
+        float ownX = slotX[slot], ownY = slotY[slot];
+        float ownVelocityX = velocityX[i], ownVelocityY = velocityY[i];
+        float moveX = 0.0f, moveY = 0.0f;
+        int bestX = -1, bestY = -1;
+        float deepestX = 0.0f, deepestY = 0.0f;
+
+        int column = grid.columnOf(ownX);
+        int row = grid.rowOf(ownY);
+        int firstColumn = std::max(column - 1, 0);
+        int lastColumn = std::min(column + 1, grid.columns() - 1);
+        for (int r = std::max(row - 1, 0); r <= std::min(row + 1, grid.rows() - 1); ++r) {
+            // The three cells of a row hold one run of slots
+            int runEnd = grid.cellEnd(r * grid.columns() + lastColumn);
+            for (int k = grid.cellBegin(r * grid.columns() + firstColumn); k < runEnd; ++k) {
+                float dx = ownX - slotX[k];
+                float dy = ownY - slotY[k];
+                float overlapX = side - std::fabs(dx);
+                float overlapY = side - std::fabs(dy);
+                if (k == slot || overlapX <= 0.0f || overlapY <= 0.0f) continue;
+
+                // Of the neighbors still closing in along an axis, the deepest one (lowest id on
+                // a tie) is the partner to trade with
+                int j = ids[k];
+                if (overlapX < overlapY) {
+                    float away = (dx > 0.0f || (dx == 0.0f && i > j)) ? 1.0f : -1.0f;
+                    moveX += away * overlapX * 0.5f;
+                    if ((ownVelocityX - velocityX[j]) * away < 0.0f &&
+                        (overlapX > deepestX || (overlapX == deepestX && j < bestX))) {
+                        deepestX = overlapX;
+                        bestX = j;
+                    }
+                }
+                else {
+                    float away = (dy > 0.0f || (dy == 0.0f && i > j)) ? 1.0f : -1.0f;
+                    moveY += away * overlapY * 0.5f;
+                    if ((ownVelocityY - velocityY[j]) * away < 0.0f &&
+                        (overlapY > deepestY || (overlapY == deepestY && j < bestY))) {
+                        deepestY = overlapY;
+                        bestY = j;
+                    }
+                }
+            }
+        }
+        pushX[i] = moveX;
+        pushY[i] = moveY;
+        partnerX[i] = bestX;
+        partnerY[i] = bestY;
+        bounceX[i] = bestX >= 0 ? velocityX[bestX] - ownVelocityX : 0.0f;
+        bounceY[i] = bestY >= 0 ? velocityY[bestY] - ownVelocityY : 0.0f;
+    }
+}
+
+// A sprite only trades with a partner that picked it back, so every trade is a full swap
+// between two sprites and the crowd keeps its energy however many sprites pile up. Contacts
+// left unpaired are still pushed apart and pair up on a later tick if they keep closing in.
+void SpriteField::applyCollisions(int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+        x[i] = std::min(std::max(x[i] + pushX[i], 0.0f), maxX);
+        y[i] = std::min(std::max(y[i] + pushY[i], 0.0f), maxY);
+        if (partnerX[i] >= 0 && partnerX[partnerX[i]] == i) velocityX[i] += bounceX[i];
+        if (partnerY[i] >= 0 && partnerY[partnerY[i]] == i) velocityY[i] += bounceY[i];
+    }
+}
+
+void SpriteField::sortByCell(const SpatialHash& grid) {
+    const int* ids = grid.ids();
+    std::vector<float>* arrays[] = { &x, &y, &previousX, &previousY, &velocityX, &velocityY };
+    for (std::vector<float>* values : arrays) {
+        for (int slot = 0; slot < count; ++slot) {
+            scratch[slot] = (*values)[ids[slot]];
+        }
+        std::copy(values->begin() + count, values->end(), scratch.begin() + count); // Padding stays put
+        values->swap(scratch);
+    }
+}
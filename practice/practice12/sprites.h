@@ -0,0 +1,61 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+#include "spatial_hash.h"
+
+// Square sprites bouncing inside a box, stored as a structure of arrays so one tick is a few
+// straight passes over float streams, four sprites per SSE instruction. The arrays are padded
+// to a multiple of four with sprites that never reach the screen, so the vector loops need no
+// scalar tail.
+class SpriteField {
+public:
+    SpriteField(int count, float size, float width, float height, uint32_t seed);
+
+    int size() const { return count; }
+    float spriteSize() const { return side; }
+
+    // Places sprite i and sets its velocity in pixels per second
+    void place(int i, float x, float y, float velocityX, float velocityY);
+
+    // Advances [begin, end) one fixed tick, bouncing off the box edges. begin and end must be
+    // multiples of four (end may also be size()), so callers can split the field into chunks.
+    void step(float dt, int begin, int end);
+    void step(float dt) { step(dt, 0, count); }
+
+    // Writes the rectangles of [begin, end) blended alpha of the way from the previous tick
+    // to the current one, ready for SDL_RenderFillRectsF
+    void interpolate(float alpha, SDL_FRect* rects, int begin, int end) const;
+    void interpolate(float alpha, SDL_FRect* rects) const { interpolate(alpha, rects, 0, count); }
+
+    // Pushes overlapping sprites apart along the axis they overlap least and swaps their
+    // velocities along it, as equal masses bouncing elastically. collide() reads every sprite but writes
+    // only the corrections of the sprites in grid slots [begin, end), and applyCollisions()
+    // adds the corrections of sprites [begin, end), so threads can split both passes by range
+    // without locking. grid must hold this tick's positions.
+    void collide(const SpatialHash& grid, int begin, int end);
+    void applyCollisions(int begin, int end);
+
+    // Reorders the sprites into grid's cell order, so sprites that are close on screen are
+    // close in memory and the collision passes read the arrays nearly in order. Sprites drift
+    // out of order slowly, so this only needs doing every so often; grid may be a few ticks
+    // old, but it must be rebuilt before the next collide().
+    void sortByCell(const SpatialHash& grid);
+
+    const float* positionsX() const { return x.data(); }
+    const float* positionsY() const { return y.data(); }
+
+private:
+    int count;
+    float side;
+    float maxX; // Largest x a sprite may have, box width less its size
+    float maxY;
+    std::vector<float> x, y;
+    std::vector<float> previousX, previousY; // Position at the previous tick, for interpolation
+    std::vector<float> velocityX, velocityY;
+    std::vector<float> pushX, pushY; // Corrections from collide(), used by applyCollisions()
+    std::vector<float> bounceX, bounceY;
+    std::vector<int> partnerX, partnerY; // Neighbor each sprite would trade with, -1 for none
+    std::vector<float> scratch; // Spare array that sortByCell() gathers into, swapped with each array in turn
+};
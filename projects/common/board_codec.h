@@ -0,0 +1,104 @@
+#ifndef BOARD_CODEC_H
+#define BOARD_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Packs match-3 boards at 3 bits per cell.
+// Values 0-7 fit, which covers EMPTY through MAGENTA_GEM in project01, project02 and project04.
+// Cell (row, col) of a rows x cols board is stored at bit 3 * (row * cols + col), least significant bit
+// first, so an 8x8 board takes 24 bytes instead of 64 four-byte enums spread over nested vectors.
+namespace BoardCodec 
+{
+    const int BITS_PER_CELL = 3;
+    const unsigned int CELL_MASK = 0x7;
+
+    // Number of bytes a packed rows x cols board occupies
+    inline size_t packedSize(int rows, int cols) 
+    {
+        return (static_cast<size_t>(rows) * cols * BITS_PER_CELL + 7) / 8;
+    }
+
+    // Reads one cell straight from packed bytes; index is row * cols + col
+    inline unsigned int getCell(const uint8_t* packed, size_t index) 
+    {
+        size_t bit = index * BITS_PER_CELL;
+        size_t byte = bit >> 3;
+        unsigned int shift = bit & 7;
+        unsigned int value = packed[byte] >> shift;
+        if (shift > 8 - BITS_PER_CELL) 
+        {
+            value |= static_cast<unsigned int>(packed[byte + 1]) << (8 - shift); // Cell straddles two bytes
+        }
+        return value & CELL_MASK;
+    }
+
+    // Overwrites one cell in packed bytes; index is row * cols + col
+    inline void setCell(uint8_t* packed, size_t index, unsigned int value) 
+    {
+        size_t bit = index * BITS_PER_CELL;
+        size_t byte = bit >> 3;
+        unsigned int shift = bit & 7;
+        unsigned int bits = (packed[byte] | (shift > 8 - BITS_PER_CELL ? packed[byte + 1] << 8 : 0));
+        bits = (bits & ~(CELL_MASK << shift)) | ((value & CELL_MASK) << shift);
+        packed[byte] = static_cast<uint8_t>(bits);
+        if (shift > 8 - BITS_PER_CELL) 
+        {
+            packed[byte + 1] = static_cast<uint8_t>(bits >> 8);
+        }
+    }
+
+    // Packs any board indexable as board[row][col] whose cells convert to 0-7 (such as the GemType enums)
+    template <typename Board>
+    void pack(const Board& board, int rows, int cols, uint8_t* out) 
+    {
+        uint32_t bits = 0; // Pending bits, least significant first
+        int bitCount = 0;
+        size_t pos = 0;
+        for (int r = 0; r < rows; ++r) 
+        {
+            for (int c = 0; c < cols; ++c) 
+            {
+                bits |= (static_cast<uint32_t>(board[r][c]) & CELL_MASK) << bitCount;
+                bitCount += BITS_PER_CELL;
+                while (bitCount >= 8) 
+                {
+                    out[pos++] = static_cast<uint8_t>(bits);
+                    bits >>= 8;
+                    bitCount -= 8;
+                }
+            }
+        }
+        if (bitCount > 0) 
+        {
+            out[pos] = static_cast<uint8_t>(bits);
+        }
+    }
+
+    // Unpacks into a rows x cols nested vector of the game's gem type
+    template <typename GemType>
+    void unpack(const uint8_t* packed, int rows, int cols, std::vector<std::vector<GemType>>& board) 
+    {
+        board.assign(rows, std::vector<GemType>(cols));
+        uint32_t bits = 0;
+        int bitCount = 0;
+        size_t pos = 0;
+        for (int r = 0; r < rows; ++r) 
+        {
+            for (int c = 0; c < cols; ++c) 
+            {
+                if (bitCount < BITS_PER_CELL) 
+                {
+                    bits |= static_cast<uint32_t>(packed[pos++]) << bitCount;
+                    bitCount += 8;
+                }
+                board[r][c] = static_cast<GemType>(bits & CELL_MASK);
+                bits >>= BITS_PER_CELL;
+                bitCount -= BITS_PER_CELL;
+            }
+        }
+    }
+}
+
+#endif // BOARD_CODEC_H
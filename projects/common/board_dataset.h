@@ -0,0 +1,238 @@
+#ifndef BOARD_DATASET_H
+#define BOARD_DATASET_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "board_codec.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// On-disk layout of a board dataset (all integers little-endian):
+//   DatasetHeader
+//   count records of recordSize bytes, each a PositionMetadata followed by a packed board
+// Records are fixed-size, so record i lives at sizeof(DatasetHeader) + i * recordSize and a
+// memory-mapped file can be walked directly without any deserialization step.
+
+const char DATASET_MAGIC[4] = { 'G', 'E', 'M', 'S' };
+const uint32_t DATASET_VERSION = 1;
+
+struct DatasetHeader 
+{
+    char magic[4]; // "GEMS"
+    uint32_t version; // DATASET_VERSION
+    uint32_t rows; // Board size shared by every record
+    uint32_t cols;
+    uint32_t recordSize; // sizeof(PositionMetadata) + BoardCodec::packedSize(rows, cols)
+    uint32_t reserved;
+    uint64_t count; // Number of records
+};
+
+// Per-position data stored in front of each packed board
+struct PositionMetadata 
+{
+    int32_t player1Score;
+    int32_t player2Score;
+    int16_t movesLeft; // -1 for games without a move limit
+    uint8_t currentPlayer; // 1 or 2
+    uint8_t flags; // Free for the analysis tools, e.g. a best-move label
+};
+
+static_assert(sizeof(DatasetHeader) == 32, "DatasetHeader must match the file layout");
+static_assert(sizeof(PositionMetadata) == 12, "PositionMetadata must match the file layout");
+
+// Streams records into a new dataset file.
+// The record count in the header is patched when the writer is closed.
+class DatasetWriter 
+{
+public:
+    DatasetWriter() : file(nullptr), packedBytes(0) { std::memset(&header, 0, sizeof(header)); }
+    ~DatasetWriter() { close(); }
+    DatasetWriter(const DatasetWriter&) = delete;
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    // Creates (or truncates) path for boards of the given size. Returns false if the file could not be created.
+    bool open(const std::string& path, int rows, int cols) 
+    {
+        close();
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+
+        std::memcpy(header.magic, DATASET_MAGIC, sizeof(header.magic));
+        header.version = DATASET_VERSION;
+        header.rows = static_cast<uint32_t>(rows);
+        header.cols = static_cast<uint32_t>(cols);
+        packedBytes = BoardCodec::packedSize(rows, cols);
+        header.recordSize = static_cast<uint32_t>(sizeof(PositionMetadata) + packedBytes);
+        header.reserved = 0;
+        header.count = 0;
+        return std::fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+
+    // Appends a board that is already packed with BoardCodec::pack
+    bool append(const PositionMetadata& metadata, const uint8_t* packedBoard) 
+    {
+        if (!file) return false;
+        if (std::fwrite(&metadata, sizeof(metadata), 1, file) != 1) return false;
+        if (std::fwrite(packedBoard, 1, packedBytes, file) != packedBytes) return false;
+        ++header.count;
+        return true;
+    }
+
+    // Rewrites the header with the final count and closes the file
+    bool close() 
+    {
+        if (!file) return true;
+        bool ok = std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = (std::fclose(file) == 0) && ok;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    std::FILE* file;
+    DatasetHeader header;
+    size_t packedBytes;
+};
+
+// Read-only, memory-mapped view of a dataset file.
+// Records are read in place; nothing is copied or decoded until a cell is asked for.
+class MappedDataset 
+{
+public:
+    MappedDataset() : data(nullptr), size(0), header(nullptr) 
+    {
+#ifdef _WIN32
+        fileHandle = INVALID_HANDLE_VALUE;
+        mappingHandle = nullptr;
+#endif
+    }
+    ~MappedDataset() { close(); }
+    MappedDataset(const MappedDataset&) = delete;
+    MappedDataset& operator=(const MappedDataset&) = delete;
+
+    // Maps path and checks its header. Returns false if the file is missing, truncated or not a dataset.
+    bool open(const std::string& path) 
+    {
+        close();
+        if (!map(path)) return false;
+
+        if (size < sizeof(DatasetHeader)) 
+        {
+            close();
+            return false;
+        }
+        header = reinterpret_cast<const DatasetHeader*>(data);
+        size_t packedBytes = BoardCodec::packedSize(header->rows, header->cols);
+        if (std::memcmp(header->magic, DATASET_MAGIC, sizeof(DATASET_MAGIC)) != 0 ||
+            header->version != DATASET_VERSION ||
+            header->recordSize != sizeof(PositionMetadata) + packedBytes ||
+            (size - sizeof(DatasetHeader)) / header->recordSize < header->count) 
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() 
+    {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mappingHandle) CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (data) munmap(const_cast<uint8_t*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+        header = nullptr;
+    }
+
+    uint64_t count() const { return header ? header->count : 0; }
+    int rows() const { return header ? static_cast<int>(header->rows) : 0; }
+    int cols() const { return header ? static_cast<int>(header->cols) : 0; }
+
+    // Packed board bytes of record i, usable with BoardCodec::getCell and BoardCodec::unpack
+    const uint8_t* board(uint64_t i) const { return record(i) + sizeof(PositionMetadata); }
+
+    // Copies out the metadata of record i (a plain copy because records are not aligned)
+    PositionMetadata metadata(uint64_t i) const 
+    {
+        PositionMetadata result;
+        std::memcpy(&result, record(i), sizeof(result));
+        return result;
+    }
+
+    // Gem value at (row, col) of record i
+    unsigned int gem(uint64_t i, int row, int col) const 
+    {
+        return BoardCodec::getCell(board(i), static_cast<size_t>(row) * header->cols + col);
+    }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    const DatasetHeader* header;
+#ifdef _WIN32
+    HANDLE fileHandle;
+    HANDLE mappingHandle;
+#endif
+
+    const uint8_t* record(uint64_t i) const 
+    {
+        return data + sizeof(DatasetHeader) + i * header->recordSize;
+    }
+
+    bool map(const std::string& path) 
+    {
+#ifdef _WIN32
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) return false;
+        size = static_cast<size_t>(fileSize.QuadPart);
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mappingHandle) return false;
+        data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        return data != nullptr;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) 
+        {
+            ::close(fd);
+            return false;
+        }
+        size = static_cast<size_t>(info.st_size);
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping stays valid after the descriptor is closed
+        if (mapped == MAP_FAILED) 
+        {
+            size = 0;
+            return false;
+        }
+        data = static_cast<const uint8_t*>(mapped);
+        return true;
+#endif
+    }
+};
+
+#endif // BOARD_DATASET_H
@@ -0,0 +1,122 @@
+#ifndef MATCH3_BENCH_H
+#define MATCH3_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include "match3_core.h"
+
+// Timings of the shared rules, so each front-end reports how its own board storage and scoring
+// perform under the same workload. Gems come from a fixed-seed generator, so every run of a
+// build does the same work and two builds can be compared line by line.
+namespace Match3 
+{
+    // xorshift32 gem source, seeded the same for every benchmark
+    struct BenchGems 
+    {
+        uint32_t state;
+
+        int operator()() 
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return 1 + static_cast<int>(state % GEM_KINDS);
+        }
+    };
+
+    // Average nanoseconds per call
+    struct BenchResult 
+    {
+        double deal;
+        double hasValidMoves;
+        double clearMatches; // On a dealt board, so every run check fails: the last check of each cascade
+        double turn; // Finding the first valid move, playing it and resolving every cascade
+    };
+
+    template <typename Board, typename Scoring>
+    BenchResult benchmarkRules(Board& board, int iterations) 
+    {
+        typedef Rules<Board, Scoring> BoardRules;
+        typedef std::chrono::steady_clock Clock;
+        BenchGems gems = { 2463534242u };
+        volatile int sink = 0; // Keeps the calls from being optimized away
+        BenchResult result;
+        auto nsSince = [iterations](Clock::time_point start) 
+        {
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+        };
+
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < iterations; ++i) 
+        {
+            BoardRules::deal(board, gems);
+        }
+        result.deal = nsSince(start);
+
+        start = Clock::now();
+        for (int i = 0; i < iterations; ++i) 
+        {
+            sink = sink + BoardRules::hasValidMoves(board);
+        }
+        result.hasValidMoves = nsSince(start);
+
+        start = Clock::now();
+        for (int i = 0; i < iterations; ++i) 
+        {
+            sink = sink + BoardRules::clearMatches(board, 1).gems;
+        }
+        result.clearMatches = nsSince(start);
+
+        start = Clock::now();
+        for (int i = 0; i < iterations; ++i) 
+        {
+            bool played = false;
+            for (int r = 0; r < board.rows() && !played; ++r) 
+            {
+                for (int c = 0; c < board.cols() && !played; ++c) 
+                {
+                    if (c + 1 < board.cols() && BoardRules::swapFormsMatch(board, r, c, r, c + 1)) 
+                    {
+                        sink = sink + BoardRules::play(board, r, c, r, c + 1, 1, gems).gems;
+                        played = true;
+                    }
+                    else if (r + 1 < board.rows() && BoardRules::swapFormsMatch(board, r, c, r + 1, c)) 
+                    {
+                        sink = sink + BoardRules::play(board, r, c, r + 1, c, 1, gems).gems;
+                        played = true;
+                    }
+                }
+            }
+            if (!played) 
+            {
+                BoardRules::deal(board, gems); // Stuck boards are redealt, as every front-end does
+            }
+        }
+        result.turn = nsSince(start);
+        return result;
+    }
+
+    inline void printBenchResult(const char* label, int rows, int cols, const BenchResult& result) 
+    {
+        std::printf("%-24s %4dx%-4d deal %10.0f ns  hasValidMoves %10.0f ns  clearMatches %10.0f ns  turn %10.0f ns\n",
+            label, rows, cols, result.deal, result.hasValidMoves, result.clearMatches, result.turn);
+    }
+
+    // Benchmarks GridBoards from the 8x8 the games play on up to 256x256, doing about the same
+    // amount of work per size
+    template <typename Cell, typename Scoring>
+    void benchmarkGridSizes(const char* label) 
+    {
+        const int SIZES[] = { 8, 16, 64, 256 };
+        for (int size : SIZES) 
+        {
+            GridBoard<Cell> board(size, size);
+            int iterations = std::max(20, 4000000 / (size * size));
+            printBenchResult(label, size, size, benchmarkRules<GridBoard<Cell>, Scoring>(board, iterations));
+        }
+    }
+}
+
+#endif // MATCH3_BENCH_H
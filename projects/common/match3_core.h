@@ -0,0 +1,601 @@
+#ifndef MATCH3_CORE_H
+#define MATCH3_CORE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// The match, drop and refill rules shared by project01's GameEngine, project02's Game and
+// project04's Game and VectorEnv. Cells hold 0 for EMPTY and 1 to GEM_KINDS for gems, the same
+// values as every GemType enum, so front-ends keep their own enums and convert at the edges.
+//
+// Rules is written once against two template parameters:
+//   Board   - where the cells live: GridBoard (owned, any size) or FixedBoard (a view of a
+//             byte buffer with compile-time size). Both index as board[row][col], keep their rows
+//             back to back (so board[0] addresses every cell) and carry the
+//             scratch space the rules need, so nothing below allocates or keeps global state.
+//   Scoring - a policy whose static table() returns the ScoreTable to pay cleared groups from.
+// An optimization to Rules therefore reaches every console and SDL build at once.
+namespace Match3 
+{
+    const int EMPTY = 0;
+    const int GEM_KINDS = 5; // Gems are 1 through GEM_KINDS
+    const int MIN_RUN = 3; // Shortest straight run that clears; Rules::forEachRun assumes 3
+
+    // One group of matched gems: a straight run, or runs of one gem that cross into an L, T or +
+    struct Group 
+    {
+        int gem;
+        int cells; // Distinct gems, so a crossing cell counts once
+        int runs; // 1 for a straight run
+        int longestRun;
+        bool crossesMiddle; // Some crossing is inside a run rather than at its end: a T or +, not an L
+        int row; // Where the runs last cross, otherwise the middle of the run
+        int col;
+        int points; // What the group paid
+    };
+
+    // Scratch kept per run while Rules::clearMatches merges crossing runs into groups
+    struct MatchRun 
+    {
+        int row; // First cell
+        int col;
+        int length;
+        bool horizontal;
+        int parent; // Union-find link; a root run holds its group's totals in group
+        Group group;
+    };
+
+    // Most runs a rows x cols board can hold at once: every third cell of each row and column
+    constexpr int maxRuns(int rows, int cols) 
+    {
+        return rows * (cols / MIN_RUN) + cols * (rows / MIN_RUN);
+    }
+
+    // A rows x cols board that owns its cells, stored row by row in one block.
+    // board[row][col] works as it did with the nested vectors this replaces.
+    template <typename CellType>
+    class GridBoard 
+    {
+    public:
+        typedef CellType Cell;
+
+        explicit GridBoard(int rows = 0, int cols = 0) { resize(rows, cols); }
+
+        // Resizes to rows x cols with every cell EMPTY
+        void resize(int newRows, int newCols) 
+        {
+            rowCount = newRows;
+            colCount = newCols;
+            cells.assign(static_cast<size_t>(newRows) * newCols, static_cast<Cell>(EMPTY));
+            markBuffer.assign(cells.size(), 0);
+            fallBuffer.assign(newCols, 0);
+            runBuffer.resize(maxRuns(newRows, newCols));
+            runAtBuffer.assign(cells.size(), 0);
+        }
+
+        int rows() const { return rowCount; }
+        int cols() const { return colCount; }
+        Cell* operator[](int row) { return cells.data() + static_cast<size_t>(row) * colCount; }
+        const Cell* operator[](int row) const { return cells.data() + static_cast<size_t>(row) * colCount; }
+
+        uint8_t* marks() { return markBuffer.data(); } // rows * cols bytes of scratch for Rules
+        int* fallDistances() { return fallBuffer.data(); } // cols entries of scratch for Rules
+        MatchRun* matchRuns() { return runBuffer.data(); } // maxRuns(rows, cols) entries of scratch for Rules
+        int* runAt() { return runAtBuffer.data(); } // rows * cols entries of scratch for Rules
+
+    private:
+        int rowCount;
+        int colCount;
+        std::vector<Cell> cells;
+        std::vector<uint8_t> markBuffer;
+        std::vector<int> fallBuffer;
+        std::vector<MatchRun> runBuffer;
+        std::vector<int> runAtBuffer;
+    };
+
+    // A view of a Rows x Cols board kept one byte per cell in memory owned by someone else,
+    // such as one board inside VectorEnv's observation buffer. Cheap to make on the stack per call.
+    // A const FixedBoard never writes through its pointer, so it may view a const buffer.
+    template <int Rows, int Cols>
+    class FixedBoard 
+    {
+    public:
+        typedef uint8_t Cell;
+
+        explicit FixedBoard(const uint8_t* cells) : cells(const_cast<uint8_t*>(cells)) {}
+
+        int rows() const { return Rows; }
+        int cols() const { return Cols; }
+        uint8_t* operator[](int row) { return cells + row * Cols; }
+        const uint8_t* operator[](int row) const { return cells + row * Cols; }
+
+        uint8_t* marks() { return markBuffer; }
+        int* fallDistances() { return fallBuffer; }
+        MatchRun* matchRuns() { return runBuffer; }
+        int* runAt() { return runAtBuffer; }
+
+    private:
+        uint8_t* cells;
+        uint8_t markBuffer[Rows * Cols];
+        int fallBuffer[Cols];
+        MatchRun runBuffer[Rows * (Cols / MIN_RUN) + Cols * (Rows / MIN_RUN)]; // maxRuns(Rows, Cols)
+        int runAtBuffer[Rows * Cols];
+    };
+
+    const int MAX_SCORED_RUN = 8; // Bigger groups are paid like groups of this many gems
+    const int MAX_SCORED_CASCADE = 8; // Deeper cascades are paid like this depth
+
+    // How a game scores, in the terms a designer tunes: what each gem is worth, then percentages
+    // by group size, for groups whose runs cross (L, T and + shapes) and by cascade depth (0 for
+    // the swap's own match, 1 for the first cascade...). A group is paid once, at the rate for its
+    // number of distinct gems, so a straight run of 4 and an L of 4 gems share a size rate.
+    // With every percentage at 100 a group pays the sum of its gems' values.
+    struct ScoreRules 
+    {
+        int gemValues[GEM_KINDS + 1]; // Indexed by gem; EMPTY is worth nothing
+        int runPercent[MAX_SCORED_RUN + 1]; // Indexed by group size; entries below MIN_RUN are unused
+        int crossPercent; // On top of runPercent for groups of crossing runs
+        int cascadePercent[MAX_SCORED_CASCADE];
+        int comboScales; // 1 if points are also multiplied by the turn's combo, 0 if not
+    };
+
+    // ScoreRules folded into one lookup per gem, shape, group size and cascade depth, so
+    // clearMatches pays a whole group with a table read and two multiplies instead of a branch per gem
+    struct ScoreTable 
+    {
+        int cellPoints[MAX_SCORED_CASCADE][GEM_KINDS + 1][2][MAX_SCORED_RUN + 1]; // Per gem of the group; [crossed][size]
+        int comboScales;
+
+        // Points for a group of cells gems of gem, crossed if its runs cross, at the given cascade depth
+        int points(int gem, int cells, bool crossed, int cascade, int combo) const 
+        {
+            int depth = std::min(cascade, MAX_SCORED_CASCADE - 1);
+            int size = std::min(cells, MAX_SCORED_RUN);
+            return cellPoints[depth][gem][crossed ? 1 : 0][size] * cells * (1 + (combo - 1) * comboScales);
+        }
+    };
+
+    constexpr ScoreTable buildScoreTable(const ScoreRules& rules) 
+    {
+        ScoreTable table = {};
+        for (int depth = 0; depth < MAX_SCORED_CASCADE; ++depth) 
+        {
+            for (int gem = 0; gem <= GEM_KINDS; ++gem) 
+            {
+                for (int size = 0; size <= MAX_SCORED_RUN; ++size) 
+                {
+                    int straight = rules.gemValues[gem] * rules.runPercent[size] / 100;
+                    table.cellPoints[depth][gem][0][size] = straight * rules.cascadePercent[depth] / 100;
+                    table.cellPoints[depth][gem][1][size] = straight * rules.crossPercent / 100 * rules.cascadePercent[depth] / 100;
+                }
+            }
+        }
+        table.comboScales = rules.comboScales;
+        return table;
+    }
+
+    // Every gem worth the same, every run length and cascade paid in full
+    constexpr ScoreRules uniformScoreRules(const int (&gemValues)[GEM_KINDS + 1], int comboScales) 
+    {
+        ScoreRules rules = {};
+        for (int gem = 0; gem <= GEM_KINDS; ++gem) 
+        {
+            rules.gemValues[gem] = gemValues[gem];
+        }
+        for (int& percent : rules.runPercent) percent = 100;
+        rules.crossPercent = 100;
+        for (int& percent : rules.cascadePercent) percent = 100;
+        rules.comboScales = comboScales;
+        return rules;
+    }
+
+    // Every gem is worth Points, whatever the combo (project04)
+    template <int Points>
+    struct FlatScoring 
+    {
+        static constexpr ScoreRules rules() 
+        {
+            return uniformScoreRules({ 0, Points, Points, Points, Points, Points }, 0);
+        }
+
+        static const ScoreTable& table() 
+        {
+            static constexpr ScoreTable TABLE = buildScoreTable(rules());
+            return TABLE;
+        }
+    };
+
+    // RED 300, GREEN 250, YELLOW 200, BLUE 150, MAGENTA 100, times the combo (project01, project02)
+    struct GemValueScoring 
+    {
+        static constexpr ScoreRules rules() 
+        {
+            return uniformScoreRules({ 0, 300, 250, 200, 150, 100 }, 1);
+        }
+
+        static const ScoreTable& table() 
+        {
+            static constexpr ScoreTable TABLE = buildScoreTable(rules());
+            return TABLE;
+        }
+    };
+
+    // What one clearMatches, resolve or play call removed
+    struct Cleared 
+    {
+        int gems; // Gems removed
+        int points; // What they were worth under the Scoring policy
+        int cascades; // Rounds of clearing, 1 when nothing falls into a new match
+    };
+
+    template <typename Board, typename Scoring>
+    struct Rules 
+    {
+        typedef typename Board::Cell Cell;
+
+        static bool inBounds(const Board& board, int row, int col) 
+        {
+            return row >= 0 && row < board.rows() && col >= 0 && col < board.cols();
+        }
+
+        static bool isAdjacent(int row1, int col1, int row2, int col2) 
+        {
+            return std::abs(row1 - row2) + std::abs(col1 - col2) == 1;
+        }
+
+        // Whether swapping two adjacent cells would form a run through either of them. Boards hold
+        // no matches between turns, so a swap can only create one through the two cells it moves,
+        // and only if their gems differ. Each moved gem is checked against its new neighbors
+        // without writing to the board.
+        static bool swapFormsMatch(const Board& board, int row1, int col1, int row2, int col2) 
+        {
+            Cell gem1 = board[row1][col1];
+            Cell gem2 = board[row2][col2];
+            if (gem1 == gem2) return false;
+            return completesRun(board, row2, col2, gem1, row1, col1) || completesRun(board, row1, col1, gem2, row2, col2);
+        }
+
+        // In bounds, adjacent and forming a match: the swaps every front-end accepts
+        static bool isValidMove(const Board& board, int row1, int col1, int row2, int col2) 
+        {
+            return inBounds(board, row1, col1) && inBounds(board, row2, col2) &&
+                isAdjacent(row1, col1, row2, col2) && swapFormsMatch(board, row1, col1, row2, col2);
+        }
+
+        static bool hasValidMoves(const Board& board) 
+        {
+            for (int r = 0; r < board.rows(); ++r) 
+            {
+                for (int c = 0; c < board.cols(); ++c) 
+                {
+                    if (c + 1 < board.cols() && swapFormsMatch(board, r, c, r, c + 1)) return true;
+                    if (r + 1 < board.rows() && swapFormsMatch(board, r, c, r + 1, c)) return true;
+                }
+            }
+            return false;
+        }
+
+        static bool hasMatches(const Board& board) 
+        {
+            return forEachRun(board, [](int, int, int, int, bool) {}) > 0;
+        }
+
+        // Calls visit(gem, row, col, length, horizontal) for every straight run of MIN_RUN or more,
+        // with (row, col) its first cell: every horizontal run row by row, then every vertical run
+        // column by column. Returns how many runs there were. Runs that cross share a cell.
+        template <typename Visit>
+        static int forEachRun(const Board& board, Visit visit) 
+        {
+            // A window of three equal cells starts a run, which is then extended to its end.
+            // Most windows fail on the first comparison, so cells outside runs cost one compare.
+            const Cell* cells = board[0];
+            const int rows = board.rows();
+            const int cols = board.cols();
+            int runs = 0;
+            for (int r = 0; r < rows; ++r) 
+            {
+                const Cell* row = cells + r * cols;
+                for (int c = 0; c + MIN_RUN <= cols; ++c) 
+                {
+                    Cell gem = row[c];
+                    if (row[c + 1] != gem || row[c + 2] != gem || static_cast<int>(gem) == EMPTY) continue;
+                    int end = c + MIN_RUN;
+                    while (end < cols && row[end] == gem) end++;
+                    visit(static_cast<int>(gem), r, c, end - c, true);
+                    runs++;
+                    c = end - 1;
+                }
+            }
+            for (int c = 0; c < cols; ++c) 
+            {
+                const Cell* column = cells + c;
+                for (int r = 0; r + MIN_RUN <= rows; ++r) 
+                {
+                    Cell gem = column[r * cols];
+                    if (column[(r + 1) * cols] != gem || column[(r + 2) * cols] != gem || static_cast<int>(gem) == EMPTY) continue;
+                    int end = r + MIN_RUN;
+                    while (end < rows && column[end * cols] == gem) end++;
+                    visit(static_cast<int>(gem), r, c, end - r, false);
+                    runs++;
+                    r = end - 1;
+                }
+            }
+            return runs;
+        }
+
+        // Empties every cell in a run. Runs that cross merge into one group, and each group is paid
+        // once from the score table for its gem, size, shape and the cascade depth.
+        static Cleared clearMatches(Board& board, int combo, int cascade = 0) 
+        {
+            return clearMatches(board, combo, cascade, [](int, int, int) {}, [](const Group&) {});
+        }
+
+        // Same, calling onClear(row, col, gem) for each gem just before it is removed
+        template <typename OnClear>
+        static Cleared clearMatches(Board& board, int combo, int cascade, OnClear onClear) 
+        {
+            return clearMatches(board, combo, cascade, onClear, [](const Group&) {});
+        }
+
+        // Same, also calling onGroup(group) for each group, after every group is paid and before
+        // any gem is removed. The board is scanned once: forEachRun feeds the marks, the groups
+        // and the clear. Horizontal runs come first, so each vertical run finds the ones it
+        // crosses through the cells they marked.
+        template <typename OnClear, typename OnGroup>
+        static Cleared clearMatches(Board& board, int combo, int cascade, OnClear onClear, OnGroup onGroup) 
+        {
+            Cleared cleared = { 0, 0, 0 };
+            const ScoreTable& scores = Scoring::table();
+            Cell* cells = board[0];
+            uint8_t* marks = board.marks();
+            MatchRun* runs = board.matchRuns();
+            int* runAt = board.runAt(); // Horizontal run through a marked cell
+            const int rows = board.rows();
+            const int cols = board.cols();
+            bool marksCleared = false; // Boards with nothing to clear never touch the marks
+            int runCount = 0;
+            forEachRun(board, [&](int gem, int row, int col, int length, bool horizontal) 
+            {
+                if (!marksCleared) 
+                {
+                    std::fill(marks, marks + static_cast<size_t>(rows) * cols, 0);
+                    marksCleared = true;
+                }
+                MatchRun& run = runs[runCount];
+                run.row = row;
+                run.col = col;
+                run.length = length;
+                run.horizontal = horizontal;
+                run.parent = runCount;
+                Group& group = run.group;
+                group.gem = gem;
+                group.cells = length;
+                group.runs = 1;
+                group.longestRun = length;
+                group.crossesMiddle = false;
+                group.row = horizontal ? row : row + length / 2;
+                group.col = horizontal ? col + length / 2 : col;
+
+                size_t cell = static_cast<size_t>(row) * cols + col;
+                const int step = horizontal ? 1 : cols;
+                for (int k = 0; k < length; ++k, cell += step) 
+                {
+                    if (horizontal) 
+                    {
+                        runAt[cell] = runCount;
+                    }
+                    else if (marks[cell]) 
+                    {
+                        joinRuns(runs, runAt[cell], runCount, row + k, col);
+                    }
+                    marks[cell] = 1;
+                }
+                runCount++;
+            });
+            if (runCount == 0) return cleared;
+            cleared.cascades = 1;
+
+            for (int i = 0; i < runCount; ++i) 
+            {
+                if (runs[i].parent != i) continue;
+                Group& group = runs[i].group;
+                group.points = scores.points(group.gem, group.cells, group.runs > 1, cascade, combo);
+                cleared.points += group.points;
+                onGroup(static_cast<const Group&>(group));
+            }
+
+            for (int i = 0; i < rows * cols; ++i) 
+            {
+                if (!marks[i]) continue;
+                int gem = static_cast<int>(cells[i]);
+                onClear(i / cols, i % cols, gem);
+                cleared.gems++;
+                cells[i] = static_cast<Cell>(EMPTY);
+            }
+            return cleared;
+        }
+
+        // Compacts every column downward with a write pointer so each gem moves at most once.
+        // Returns how far each column fell, which is also the number of empty cells left at its
+        // top (cols entries, valid until the next drop). Runs on the calling thread: a drop is far
+        // cheaper than starting threads, and front-ends that want cores busy run many boards at once.
+        static const int* drop(Board& board) 
+        {
+            int* fall = board.fallDistances();
+            dropColumns(board, 0, board.cols(), fall, [](int, int, int) {});
+            return fall;
+        }
+
+        // Same, calling onMove(fromRow, toRow, col) for every gem that moves
+        template <typename OnMove>
+        static const int* drop(Board& board, OnMove onMove) 
+        {
+            int* fall = board.fallDistances();
+            dropColumns(board, 0, board.cols(), fall, onMove);
+            return fall;
+        }
+
+        // Fills the top fall[col] cells of each column with nextGem(), each column bottom up,
+        // calling onFill(row, col, fall[col]) for every new gem
+        template <typename NextGem, typename OnFill>
+        static void refill(Board& board, const int* fall, NextGem& nextGem, OnFill onFill) 
+        {
+            Cell* cells = board[0];
+            const int cols = board.cols();
+            for (int c = 0; c < cols; ++c) 
+            {
+                for (int r = fall[c] - 1; r >= 0; --r) 
+                {
+                    cells[r * cols + c] = static_cast<Cell>(nextGem());
+                    onFill(r, c, fall[c]);
+                }
+            }
+        }
+
+        template <typename NextGem>
+        static void refill(Board& board, const int* fall, NextGem& nextGem) 
+        {
+            refill(board, fall, nextGem, [](int, int, int) {});
+        }
+
+        // Deals a fresh board with no match on it and at least one valid move. Each gem is drawn
+        // again while it would complete a run with the two cells above or to its left, so the
+        // board is built match-free in one pass instead of being redrawn whole until it is.
+        template <typename NextGem>
+        static void deal(Board& board, NextGem& nextGem) 
+        {
+            Cell* cells = board[0];
+            const int rows = board.rows();
+            const int cols = board.cols();
+            do 
+            {
+                for (int r = 0; r < rows; ++r) 
+                {
+                    for (int c = 0; c < cols; ++c) 
+                    {
+                        Cell* cell = cells + r * cols + c;
+                        Cell gem;
+                        do 
+                        {
+                            gem = static_cast<Cell>(nextGem());
+                        } while ((r >= 2 && cell[-cols] == gem && cell[-2 * cols] == gem) ||
+                            (c >= 2 && cell[-1] == gem && cell[-2] == gem));
+                        *cell = gem;
+                    }
+                }
+            } while (!hasValidMoves(board));
+        }
+
+        // Clears, drops and refills until the board holds no match
+        template <typename NextGem>
+        static Cleared resolve(Board& board, int combo, NextGem& nextGem) 
+        {
+            Cleared total = { 0, 0, 0 };
+            for (Cleared round = clearMatches(board, combo, 0); round.gems > 0; round = clearMatches(board, combo, total.cascades)) 
+            {
+                total.gems += round.gems;
+                total.points += round.points;
+                total.cascades++;
+                refill(board, drop(board), nextGem);
+            }
+            return total;
+        }
+
+        // Plays a swap and resolves every cascade. A swap that is out of bounds, not adjacent or
+        // forms no match leaves the board untouched and clears nothing.
+        template <typename NextGem>
+        static Cleared play(Board& board, int row1, int col1, int row2, int col2, int combo, NextGem& nextGem) 
+        {
+            if (!isValidMove(board, row1, col1, row2, col2)) 
+            {
+                Cleared nothing = { 0, 0, 0 };
+                return nothing;
+            }
+            std::swap(board[row1][col1], board[row2][col2]);
+            return resolve(board, combo, nextGem);
+        }
+
+    private:
+        static int findRoot(MatchRun* runs, int i) 
+        {
+            while (runs[i].parent != i) 
+            {
+                runs[i].parent = runs[runs[i].parent].parent; // Path halving
+                i = runs[i].parent;
+            }
+            return i;
+        }
+
+        // Merges the groups of horizontal run h and vertical run v, which cross at (row, col)
+        static void joinRuns(MatchRun* runs, int h, int v, int row, int col) 
+        {
+            const MatchRun& across = runs[h];
+            const MatchRun& down = runs[v];
+            bool middle = (col != across.col && col != across.col + across.length - 1) ||
+                (row != down.row && row != down.row + down.length - 1);
+            int rootH = findRoot(runs, h);
+            int rootV = findRoot(runs, v);
+            Group& group = runs[rootH].group;
+            if (rootV != rootH) 
+            {
+                const Group& other = runs[rootV].group;
+                runs[rootV].parent = rootH;
+                group.cells += other.cells;
+                group.runs += other.runs;
+                group.longestRun = std::max(group.longestRun, other.longestRun);
+                group.crossesMiddle = group.crossesMiddle || other.crossesMiddle;
+            }
+            group.cells--; // The crossing cell was counted by both runs
+            group.crossesMiddle = group.crossesMiddle || middle;
+            group.row = row;
+            group.col = col;
+        }
+
+        template <typename OnMove>
+        static void dropColumns(Board& board, int firstCol, int lastCol, int* fall, OnMove onMove) 
+        {
+            Cell* cells = board[0];
+            const int rows = board.rows();
+            const int cols = board.cols();
+            for (int c = firstCol; c < lastCol; ++c) 
+            {
+                int writeRow = rows - 1;
+                for (int r = rows - 1; r >= 0; --r) 
+                {
+                    Cell gem = cells[r * cols + c];
+                    if (static_cast<int>(gem) == EMPTY) continue;
+                    if (writeRow != r) 
+                    {
+                        cells[writeRow * cols + c] = gem;
+                        cells[r * cols + c] = static_cast<Cell>(EMPTY);
+                        onMove(r, writeRow, c);
+                    }
+                    writeRow--;
+                }
+                fall[c] = writeRow + 1;
+            }
+        }
+
+        // Whether gem, moved into (row, col) from the adjacent (fromRow, fromCol), lines up with
+        // at least MIN_RUN - 1 matching neighbors in a row or column. The cell it came from now
+        // holds the other gem, so that direction never counts.
+        static bool completesRun(const Board& board, int row, int col, Cell gem, int fromRow, int fromCol) 
+        {
+            if (static_cast<int>(gem) == EMPTY) return false;
+            const Cell* cells = board[row];
+            int horizontal = 0;
+            for (int c = col - 1; c >= 0 && fromCol != col - 1 && cells[c] == gem; --c) horizontal++;
+            for (int c = col + 1; c < board.cols() && fromCol != col + 1 && cells[c] == gem; ++c) horizontal++;
+            if (horizontal >= MIN_RUN - 1) return true;
+
+            int vertical = 0;
+            for (int r = row - 1; r >= 0 && fromRow != row - 1 && board[r][col] == gem; --r) vertical++;
+            for (int r = row + 1; r < board.rows() && fromRow != row + 1 && board[r][col] == gem; ++r) vertical++;
+            return vertical >= MIN_RUN - 1;
+        }
+    };
+}
+
+#endif // MATCH3_CORE_H
@@ -0,0 +1,165 @@
+#ifndef MATCH3_HINTS_H
+#define MATCH3_HINTS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "match3_core.h"
+
+// How many gems every adjacent swap on a board would clear straight away, kept up to date as
+// cells change instead of being searched for when a hint is wanted.
+//
+// A swap only depends on the rows and columns of the two cells it moves, since a moved gem
+// matches along its new row and column only. So a changed cell marks its row and column stale,
+// and the next query rescores just the swaps that touch a stale row or column. The owner reports
+// every change through cellChanged (or boardChanged after rewriting the whole board).
+namespace Match3 
+{
+    template <typename Board>
+    class SwapIndex 
+    {
+    public:
+        typedef typename Board::Cell Cell;
+
+        struct Swap 
+        {
+            int row1, col1, row2, col2;
+            int clears; // Gems cleared before anything falls, 0 if the swap forms no match
+        };
+
+        SwapIndex() : rowCount(0), colCount(0), stale(false) {}
+
+        // Sizes the index for a rows x cols board and marks every swap stale
+        void resize(int rows, int cols) 
+        {
+            rowCount = rows;
+            colCount = cols;
+            horizontalClears.assign(static_cast<size_t>(rows) * (cols > 0 ? cols - 1 : 0), 0);
+            verticalClears.assign(static_cast<size_t>(rows > 0 ? rows - 1 : 0) * cols, 0);
+            staleRows.assign(rows, 1);
+            staleCols.assign(cols, 1);
+            stale = true;
+        }
+
+        void cellChanged(int row, int col) 
+        {
+            staleRows[row] = 1;
+            staleCols[col] = 1;
+            stale = true;
+        }
+
+        void boardChanged() 
+        {
+            std::fill(staleRows.begin(), staleRows.end(), 1);
+            std::fill(staleCols.begin(), staleCols.end(), 1);
+            stale = true;
+        }
+
+        // Rescores the stale swaps and finds the one that clears the most gems, the first in
+        // row-major order on a tie (horizontal before vertical). Returns false if no swap matches.
+        // board must hold no matches, as it does between turns.
+        bool best(const Board& board, Swap& swap) 
+        {
+            refresh(board);
+            int bestClears = 0;
+            for (int r = 0; r < rowCount; ++r) 
+            {
+                for (int c = 0; c < colCount; ++c) 
+                {
+                    if (c + 1 < colCount && horizontalClears[r * (colCount - 1) + c] > bestClears) 
+                    {
+                        bestClears = horizontalClears[r * (colCount - 1) + c];
+                        swap = { r, c, r, c + 1, bestClears };
+                    }
+                    if (r + 1 < rowCount && verticalClears[r * colCount + c] > bestClears) 
+                    {
+                        bestClears = verticalClears[r * colCount + c];
+                        swap = { r, c, r + 1, c, bestClears };
+                    }
+                }
+            }
+            return bestClears > 0;
+        }
+
+    private:
+        int rowCount;
+        int colCount;
+        std::vector<int> horizontalClears; // (r, c) with (r, c + 1), rows * (cols - 1) entries
+        std::vector<int> verticalClears; // (r, c) with (r + 1, c), (rows - 1) * cols entries
+        std::vector<uint8_t> staleRows;
+        std::vector<uint8_t> staleCols;
+        bool stale;
+
+        void refresh(const Board& board) 
+        {
+            if (!stale) return;
+            for (int r = 0; r < rowCount; ++r) 
+            {
+                if (!staleRows[r]) continue;
+                for (int c = 0; c + 1 < colCount; ++c) 
+                {
+                    scoreHorizontal(board, r, c);
+                }
+                for (int c = 0; c < colCount; ++c) 
+                {
+                    if (r > 0) scoreVertical(board, r - 1, c);
+                    if (r + 1 < rowCount) scoreVertical(board, r, c);
+                }
+                staleRows[r] = 0;
+            }
+            for (int c = 0; c < colCount; ++c) 
+            {
+                if (!staleCols[c]) continue;
+                for (int r = 0; r + 1 < rowCount; ++r) 
+                {
+                    scoreVertical(board, r, c);
+                }
+                for (int r = 0; r < rowCount; ++r) 
+                {
+                    if (c > 0) scoreHorizontal(board, r, c - 1);
+                    if (c + 1 < colCount) scoreHorizontal(board, r, c);
+                }
+                staleCols[c] = 0;
+            }
+            stale = false;
+        }
+
+        void scoreHorizontal(const Board& board, int row, int col) 
+        {
+            horizontalClears[row * (colCount - 1) + col] = swapClears(board, row, col, row, col + 1);
+        }
+
+        void scoreVertical(const Board& board, int row, int col) 
+        {
+            verticalClears[row * colCount + col] = swapClears(board, row, col, row + 1, col);
+        }
+
+        // The two moved gems differ, so the runs they form never share a cell
+        int swapClears(const Board& board, int row1, int col1, int row2, int col2) const 
+        {
+            Cell gem1 = board[row1][col1];
+            Cell gem2 = board[row2][col2];
+            if (gem1 == gem2) return 0;
+            return runClears(board, row2, col2, gem1, row1, col1) + runClears(board, row1, col1, gem2, row2, col2);
+        }
+
+        // Gems cleared by gem landing in (row, col) from the adjacent (fromRow, fromCol): its row
+        // run and column run, each only if long enough, with the landing cell counted once
+        int runClears(const Board& board, int row, int col, Cell gem, int fromRow, int fromCol) const 
+        {
+            if (static_cast<int>(gem) == EMPTY) return 0;
+            const Cell* cells = board[row];
+            int horizontal = 0;
+            for (int c = col - 1; c >= 0 && fromCol != col - 1 && cells[c] == gem; --c) horizontal++;
+            for (int c = col + 1; c < colCount && fromCol != col + 1 && cells[c] == gem; ++c) horizontal++;
+            int vertical = 0;
+            for (int r = row - 1; r >= 0 && fromRow != row - 1 && board[r][col] == gem; --r) vertical++;
+            for (int r = row + 1; r < rowCount && fromRow != row + 1 && board[r][col] == gem; ++r) vertical++;
+
+            int cleared = (horizontal >= MIN_RUN - 1 ? horizontal : 0) + (vertical >= MIN_RUN - 1 ? vertical : 0);
+            return cleared > 0 ? cleared + 1 : 0;
+        }
+    };
+}
+
+#endif // MATCH3_HINTS_H
@@ -0,0 +1,186 @@
+#ifndef MATCH3_SCORING_H
+#define MATCH3_SCORING_H
+
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "match3_core.h"
+
+// Score files, for tuning a game's scoring without rebuilding it. A score file is plain text,
+// one setting per line, '#' to the end of a line is a comment:
+//
+//   gems = 300 250 200 150 100        # RED GREEN YELLOW BLUE MAGENTA
+//   runs = 100 120 150                # Percent paid for groups of 3, 4, 5 ... gems
+//   crosses = 150                     # Percent paid on top for L, T and + groups
+//   cascades = 100 150 200            # Percent paid at cascade depth 0, 1, 2 ...
+//   combo = 1                         # 1 to multiply by the turn's combo, 0 not to
+//
+// Runs of one gem that cross are one group, paid once for all of its gems: an L of 3 and 3 is a
+// group of 5, paid at the runs rate for 5 times the crosses rate.
+// Settings left out keep the game's own values. gems needs a value per gem; runs and cascades
+// may stop early, in which case their last value carries on to the bigger groups or deeper cascades.
+namespace Match3 
+{
+    // Applies the settings read from in over rules. Returns false, with error naming the line,
+    // if any line is malformed; rules is only changed when every line is good.
+    inline bool parseScoreRules(std::istream& in, ScoreRules& rules, std::string& error) 
+    {
+        ScoreRules parsed = rules;
+        std::string line;
+        for (int lineNumber = 1; std::getline(in, line); ++lineNumber) 
+        {
+            line = line.substr(0, line.find('#'));
+            size_t equals = line.find('=');
+            std::istringstream keyStream(line.substr(0, equals));
+            std::string key;
+            if (!(keyStream >> key)) continue; // Blank or comment only
+            if (equals == std::string::npos) 
+            {
+                error = "line " + std::to_string(lineNumber) + ": expected key = values";
+                return false;
+            }
+
+            std::istringstream valueStream(line.substr(equals + 1));
+            int values[MAX_SCORED_RUN + MAX_SCORED_CASCADE];
+            int count = 0;
+            int value;
+            while (count < MAX_SCORED_RUN + MAX_SCORED_CASCADE && valueStream >> value) 
+            {
+                values[count++] = value;
+            }
+            std::string rest;
+            valueStream.clear();
+            if (valueStream >> rest || count == 0) 
+            {
+                error = "line " + std::to_string(lineNumber) + ": " + key + " takes whole numbers only";
+                return false;
+            }
+            for (int i = 0; i < count; ++i) 
+            {
+                if (values[i] < 0) 
+                {
+                    error = "line " + std::to_string(lineNumber) + ": " + key + " cannot be negative";
+                    return false;
+                }
+            }
+
+            if (key == "gems" && count == GEM_KINDS) 
+            {
+                for (int gem = 1; gem <= GEM_KINDS; ++gem) 
+                {
+                    parsed.gemValues[gem] = values[gem - 1];
+                }
+            }
+            else if (key == "runs" && count <= MAX_SCORED_RUN - MIN_RUN + 1) 
+            {
+                for (int run = MIN_RUN; run <= MAX_SCORED_RUN; ++run) 
+                {
+                    parsed.runPercent[run] = values[std::min(run - MIN_RUN, count - 1)];
+                }
+            }
+            else if (key == "crosses" && count == 1) 
+            {
+                parsed.crossPercent = values[0];
+            }
+            else if (key == "cascades" && count <= MAX_SCORED_CASCADE) 
+            {
+                for (int depth = 0; depth < MAX_SCORED_CASCADE; ++depth) 
+                {
+                    parsed.cascadePercent[depth] = values[std::min(depth, count - 1)];
+                }
+            }
+            else if (key == "combo" && count == 1 && values[0] <= 1) 
+            {
+                parsed.comboScales = values[0];
+            }
+            else 
+            {
+                error = "line " + std::to_string(lineNumber) + ": unknown setting or wrong number of values for " + key;
+                return false;
+            }
+        }
+        rules = parsed;
+        return true;
+    }
+
+    inline bool loadScoreRules(const std::string& path, ScoreRules& rules, std::string& error) 
+    {
+        std::ifstream file(path);
+        if (!file) 
+        {
+            error = "could not open " + path;
+            return false;
+        }
+        return parseScoreRules(file, rules, error);
+    }
+
+    // Base's scoring, with a table that can be replaced from a score file while the game runs.
+    // The table is shared by everything using this policy; replace it between turns, never
+    // while another thread is inside clearMatches.
+    template <typename Base>
+    struct TunableScoring 
+    {
+        static const ScoreTable& table() { return current(); }
+
+        // Applies path over Base's rules. Returns false, keeping the current table, if it is unreadable.
+        static bool load(const std::string& path, std::string& error) 
+        {
+            ScoreRules loaded = Base::rules();
+            if (!loadScoreRules(path, loaded, error)) return false;
+            current() = buildScoreTable(loaded);
+            return true;
+        }
+
+        // Back to Base's own table
+        static void reset() { current() = Base::table(); }
+
+    private:
+        static ScoreTable& current() 
+        {
+            static ScoreTable table = Base::table();
+            return table;
+        }
+    };
+
+    // Reloads a score file into a TunableScoring whenever the file changes on disk. Front-ends
+    // poll it between turns, so a designer can edit the file while the game runs. A change is a
+    // new modification time or size; st_mtime only has whole seconds, so where the platform
+    // keeps the nanoseconds too (Linux) two saves within one second are still told apart.
+    template <typename Tunable>
+    class ScoreFileWatcher 
+    {
+    public:
+        explicit ScoreFileWatcher(const std::string& path) : path(path), lastModified(0), lastNanoseconds(0), lastSize(-1) {}
+
+        // Returns true if the file changed and its scores were applied. A changed file that does
+        // not parse returns false with error set and leaves the scores as they were; error is
+        // empty when the file is missing or unchanged.
+        bool poll(std::string& error) 
+        {
+            error.clear();
+            struct stat info;
+            if (stat(path.c_str(), &info) != 0) return false;
+            long nanoseconds = 0;
+#ifdef __linux__
+            nanoseconds = info.st_mtim.tv_nsec;
+#endif
+            long long size = static_cast<long long>(info.st_size);
+            if (info.st_mtime == lastModified && nanoseconds == lastNanoseconds && size == lastSize) return false;
+            lastModified = info.st_mtime;
+            lastNanoseconds = nanoseconds;
+            lastSize = size;
+            return Tunable::load(path, error);
+        }
+
+    private:
+        std::string path;
+        time_t lastModified;
+        long lastNanoseconds;
+        long long lastSize; // -1 until the file is first seen
+    };
+}
+
+#endif // MATCH3_SCORING_H
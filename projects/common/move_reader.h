@@ -0,0 +1,120 @@
+#ifndef MOVE_READER_H
+#define MOVE_READER_H
+
+#include <cstddef>
+#include <cstdio>
+
+// Move files for the batch modes of the front-ends: whitespace separated groups of
+// "row1 col1 row2 col2" with 1-based coordinates like the interactive prompts, where '#'
+// starts a comment that runs to the end of the line. Integers are read from the FILE through
+// a fixed buffer, without going through iostreams per token.
+//
+// The batch modes take "--seed N" so a replay deals the same boards every run.
+namespace Match3 
+{
+    class MoveReader 
+    {
+    public:
+        explicit MoveReader(std::FILE* input) : input(input), pos(0), end(0), line(1), malformed(false) {}
+
+        // Reads the next integer. Returns false at end of input or on a malformed token.
+        bool nextInt(int& value) 
+        {
+            int c = skipBlanks();
+            if (c == EOF) return false;
+            if (c < '0' || c > '9') 
+            {
+                malformed = true;
+                return false;
+            }
+            value = 0;
+            while (c >= '0' && c <= '9') 
+            {
+                if (value < 100000000) value = value * 10 + (c - '0'); // Saturate instead of overflowing
+                ++pos;
+                c = peek();
+            }
+            return true;
+        }
+
+        // Reads the four coordinates of the next move, as written in the file. Returns false at
+        // the end of input or on a malformed token; a partial move at the end counts as malformed.
+        bool nextMove(int (&coords)[4]) 
+        {
+            int count = 0;
+            while (count < 4 && nextInt(coords[count])) 
+            {
+                ++count;
+            }
+            if (count > 0 && count < 4) malformed = true;
+            return count == 4;
+        }
+
+        bool isMalformed() const { return malformed; }
+        long long getLine() const { return line; } // Line being read, so of the bad token once malformed
+
+    private:
+        std::FILE* input;
+        char buffer[1 << 16];
+        size_t pos;
+        size_t end;
+        long long line;
+        bool malformed;
+
+        int peek() 
+        {
+            if (pos == end) 
+            {
+                end = std::fread(buffer, 1, sizeof(buffer), input);
+                pos = 0;
+                if (end == 0) return EOF;
+            }
+            return static_cast<unsigned char>(buffer[pos]);
+        }
+
+        // Skips whitespace and comments, returning the first character of the next token
+        int skipBlanks() 
+        {
+            int c = peek();
+            while (c != EOF) 
+            {
+                if (c == '#') 
+                {
+                    while (c != EOF && c != '\n') 
+                    {
+                        ++pos;
+                        c = peek();
+                    }
+                }
+                else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') 
+                {
+                    if (c == '\n') ++line;
+                    ++pos;
+                    c = peek();
+                }
+                else 
+                {
+                    break;
+                }
+            }
+            return c;
+        }
+    };
+
+    // Reads the value of a batch mode's --seed option: decimal digits only, up to 4294967295
+    inline bool parseSeed(const char* text, unsigned int& seed) 
+    {
+        if (*text == '\0') return false;
+        unsigned long long value = 0;
+        for (; *text != '\0'; ++text) 
+        {
+            if (*text < '0' || *text > '9') return false;
+            value = value * 10 + (*text - '0');
+            if (value > 0xFFFFFFFFull) return false;
+        }
+        seed = static_cast<unsigned int>(value);
+        return true;
+    }
+}
+
+#endif // MOVE_READER_H
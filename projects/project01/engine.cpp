@@ -0,0 +1,75 @@
+#include "engine.h"
+
+GameEngine::GameEngine(int rows, int cols, unsigned int seed) : board(rows, cols), currentPlayer(1), combo(1), gen(seed), gemDistribution(1, Match3::GEM_KINDS) 
+{
+    makeBoard();
+}
+
+void GameEngine::reset() 
+{
+    makeBoard();
+    player1.score = 0;
+    player2.score = 0;
+    currentPlayer = 1;
+    combo = 1;
+}
+
+GameState GameEngine::status() const 
+{
+    if (player1.score >= WINNING_SCORE) return GameState::PLAYER_1_WINS;
+    if (player2.score >= WINNING_SCORE) return GameState::PLAYER_2_WINS;
+
+    return GameState::ONGOING;
+}
+
+GameEngine::MoveResult GameEngine::applyMove(int row1, int col1, int row2, int col2) 
+{
+    MoveResult result = MoveResult::INVALID;
+    if (inBounds(row1, col1) && inBounds(row2, col2) && Rules::isAdjacent(row1, col1, row2, col2)) 
+    {
+        // Swaps, then clears, drops and refills until no match is left; a swap that forms no match is not made
+        auto nextGem = [this]() { return gemDistribution(gen); };
+        Match3::Cleared cleared = Rules::play(board, row1, col1, row2, col2, combo, nextGem);
+        if (cleared.gems > 0) 
+        {
+            if (currentPlayer == 1) 
+            {
+                player1.score += cleared.points;
+            }
+            else 
+            {
+                player2.score += cleared.points;
+            }
+            if (!Rules::hasValidMoves(board)) 
+            {
+                makeBoard();
+                combo = 1;
+                result = MoveResult::RESHUFFLED;
+            }
+            else 
+            {
+                combo++;
+                result = MoveResult::MATCHED;
+            }
+        }
+        else 
+        {
+            combo = 1;
+            result = MoveResult::NO_MATCH;
+        }
+    }
+    else 
+    {
+        combo = 1;
+    }
+
+    currentPlayer = (currentPlayer == 1) ? 2 : 1;
+    return result;
+}
+
+// Deals a board with no matches and at least one valid move
+void GameEngine::makeBoard() 
+{
+    auto nextGem = [this]() { return gemDistribution(gen); };
+    Rules::deal(board, nextGem);
+}
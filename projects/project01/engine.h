@@ -0,0 +1,65 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <random>
+#include "../common/match3_scoring.h"
+
+// Enum for different game states
+enum class GameState { ONGOING, PLAYER_1_WINS, PLAYER_2_WINS, DRAW };
+// Enum for different gem types
+enum class GemType { EMPTY, RED_GEM, GREEN_GEM, YELLOW_GEM, BLUE_GEM, MAGENTA_GEM };
+
+// Structure to represent a player
+struct Player 
+{
+    int score = 0;
+};
+
+// All the rules and state for one game of Bejeweled.
+// Nothing is shared between instances, so independent games can run on different threads.
+// The one exception is the score table, which is only read during play; load a score file
+// into Scoring between turns, not while other games are playing.
+class GameEngine 
+{
+public:
+    // What happened to a move passed to applyMove
+    enum class MoveResult { INVALID, NO_MATCH, MATCHED, RESHUFFLED };
+
+    static const int WINNING_SCORE = 5000;
+
+    // Gem values times the combo, retunable from a score file (see match3_scoring.h)
+    typedef Match3::TunableScoring<Match3::GemValueScoring> Scoring;
+
+    // Creates a rows x cols game; the seed makes the gem sequence reproducible
+    GameEngine(int rows = 8, int cols = 8, unsigned int seed = std::random_device{}());
+
+    // Starts a new game on a fresh board with scores and combo reset
+    void reset();
+
+    // Applies a 0-based move for the current player and passes the turn
+    MoveResult applyMove(int row1, int col1, int row2, int col2);
+
+    GameState status() const;
+    int getRows() const { return board.rows(); }
+    int getCols() const { return board.cols(); }
+    GemType getGem(int row, int col) const { return board[row][col]; }
+    int getCurrentPlayer() const { return currentPlayer; }
+    int getScore(int player) const { return player == 1 ? player1.score : player2.score; }
+    int getCombo() const { return combo; }
+    bool inBounds(int row, int col) const { return Rules::inBounds(board, row, col); }
+
+private:
+    typedef Match3::GridBoard<GemType> Board;
+    typedef Match3::Rules<Board, Scoring> Rules; // Match, drop and refill rules shared with project02 and project04
+
+    Board board; // Gems, row by row
+    Player player1, player2; // Player objects
+    int currentPlayer; // Variable to keep track of the current player
+    int combo; // Combo multiplier, grows with consecutive matching turns
+    std::mt19937 gen; // Per-game random source
+    std::uniform_int_distribution<int> gemDistribution; // Gem types 1-5
+
+    void makeBoard();
+};
+
+#endif // ENGINE_H
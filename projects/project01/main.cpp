@@ -1,8 +1,17 @@
 #include <iostream>
 #include <vector>
-#include <random>
+#include <string>
 #include <limits>
 #include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include "engine.h"
+#include "../common/match3_bench.h"
+#include "../common/move_reader.h"
 
 // Color codes for terminal output
 #define RESET "\033[0m"
@@ -12,68 +21,76 @@
 #define BLUE "\033[34m"
 #define MAGENTA "\033[35m"
 
-// Enum for different game states
-enum class GameState { ONGOING, PLAYER_1_WINS, PLAYER_2_WINS, DRAW };
-// Enum for different gem types
-enum class GemType { EMPTY, RED_GEM, GREEN_GEM, YELLOW_GEM, BLUE_GEM, MAGENTA_GEM };
-
-// Structure to represent a player
-struct Player 
-{
-    int score = 0;
-};
-
-// Global variables
-std::vector<std::vector<GemType>> board; // 2D vector to represent the game board
-Player player1, player2; // Player objects
-int currentPlayer = 1; // Variable to keep track of the current player
-
 // Function Declarations
 void printRules();
-void makeBoard(int rows, int cols);
-void printBoard();
-GameState gameStatus();
-int play(int combo);
-void swapGems(int row1, int col1, int row2, int col2, bool printMessage = true);
-bool matchGems(int row, int col);
-void removeMatches(Player& player, int combo);
-void dropGems();
-void fillBoard();
-std::pair<int, int> getUserInput(const std::string& prompt);
-bool isValidMove(int row1, int col1, int row2, int col2);
-int calculatePoints(GemType gem);
-bool hasValidMoves();
-bool checkPotentialMatch(int row1, int col1, int row2, int col2);
-
-int main() 
+void printBoard(const GameEngine& game);
+void play(GameEngine& game);
+std::pair<int, int> getUserInput(const std::string& prompt, const GameEngine& game);
+int runBatch(int fileCount, char* files[], unsigned int seed);
+
+// Usage: project01 --batch [--seed N] [movefile...] | project01 --bench
+// Batch mode replays moves from each file (or stdin) without printing the board and ends with a summary.
+// Several files are replayed as independent games in parallel, all dealt from the same seed; without
+// --seed a random one is used and printed, so the run can be repeated.
+// Bench mode times the shared match-3 rules on GameEngine's board storage and scoring.
+// Interactive play rereads scores.cfg (see match3_scoring.h) before a turn whenever it changes.
+int main(int argc, char* argv[]) 
 {
+    if (argc > 1 && std::strcmp(argv[1], "--batch") == 0) 
+    {
+        int first = 2;
+        unsigned int seed = std::random_device{}();
+        if (argc > 2 && std::strcmp(argv[2], "--seed") == 0) 
+        {
+            if (argc < 4 || !Match3::parseSeed(argv[3], seed)) 
+            {
+                std::fprintf(stderr, "--seed needs a number from 0 to 4294967295\n");
+                return 1;
+            }
+            first = 4;
+        }
+        return runBatch(argc - first, argv + first, seed);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) 
+    {
+        Match3::benchmarkGridSizes<GemType, GameEngine::Scoring>("project01 GameEngine");
+        return 0;
+    }
+
     printRules(); // Display the game rules
 
+    GameEngine game(8, 8); // 8 rows and 8 columns
+    Match3::ScoreFileWatcher<GameEngine::Scoring> scoreWatcher("scores.cfg"); // Optional, reread before a turn when it changes
 	bool playAgain = true; // Variable to control the game loop
     while (playAgain) 
 	{ 
-        makeBoard(8, 8); // Initialize the game board with 8 rows and 8 columns
-        player1.score = 0; // Reset player scores
-        player2.score = 0;
-        currentPlayer = 1; // Start with player 1
-        int combo = 1; // Initialize combo counter
+        game.reset(); // New board, scores and combo reset, player 1 starts
 
-        while (gameStatus() == GameState::ONGOING) // Play until the game is over
+        while (game.status() == GameState::ONGOING) // Play until the game is over
         { 
             std::cout << "Game in Progress\n"; // Display game status
-            combo = play(combo); // Play a turn and update combo
+            std::string scoreError;
+            if (scoreWatcher.poll(scoreError)) 
+            {
+                std::cout << "Loaded new scores from scores.cfg\n";
+            }
+            else if (!scoreError.empty()) 
+            {
+                std::cout << "Kept the previous scores: " << scoreError << "\n";
+            }
+            play(game); // Play a turn
         }
 
         // Display game end message based on game status
-        if (gameStatus() == GameState::PLAYER_1_WINS) 
+        if (game.status() == GameState::PLAYER_1_WINS) 
         {
             std::cout << "AWESOME!!!! Player 1 is the Winner!\n";
         }
-        else if (gameStatus() == GameState::PLAYER_2_WINS) 
+        else if (game.status() == GameState::PLAYER_2_WINS) 
         {
             std::cout << "AWESOME!!!! Player 2 is the Winner!\n";
         }
-        else if (gameStatus() == GameState::DRAW) 
+        else if (game.status() == GameState::DRAW) 
         {
             std::cout << "IT'S A DRAW!\n";
         }
@@ -104,45 +121,20 @@ void printRules()
     std::cout << "MAGENTA = 100 points each\n";
 }
 
-void makeBoard(int rows, int cols) 
-{
-    board.assign(rows, std::vector<GemType>(cols));
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distrib(1, 5);
-
-    for (int i = 0; i < rows; ++i) 
-    {
-        for (int j = 0; j < cols; ++j) 
-        {
-            board[i][j] = static_cast<GemType>(distrib(gen));
-        }
-    }
-    while (!hasValidMoves()) 
-    {
-        for (int i = 0; i < rows; ++i) 
-        {
-            for (int j = 0; j < cols; ++j) 
-            {
-                board[i][j] = static_cast<GemType>(distrib(gen));
-            }
-        }
-    }
-}
-
-void printBoard() {
+void printBoard(const GameEngine& game) {
     std::cout << "     "; 
-    for (int j = 0; j < static_cast<int>(board.size()); ++j) 
+    for (int j = 0; j < game.getCols(); ++j) 
     { 
         std::cout << std::setw(5) << j + 1 << " "; 
     }
     std::cout << std::endl;
 
-    for (int i = 0; i < static_cast<int>(board.size()); ++i) 
+    for (int i = 0; i < game.getRows(); ++i) 
     {
         std::cout << std::setw(3) << i + 1 << "  "; // Print row numbers
-        for (const auto& gem : board[i]) // Iterate through each gem in the row
+        for (int j = 0; j < game.getCols(); ++j) // Iterate through each gem in the row
         { 
+            GemType gem = game.getGem(i, j);
             if (gem == GemType::RED_GEM) 
             {
                 std::cout << RED << std::setw(5) << "R" << RESET << " ";
@@ -172,166 +164,40 @@ void printBoard() {
     }
 }
 
-GameState gameStatus() {
-    const int winningScore = 5000; // Winning score is 5000
-
-    if (player1.score >= winningScore) return GameState::PLAYER_1_WINS;
-    if (player2.score >= winningScore) return GameState::PLAYER_2_WINS;
-
-    return GameState::ONGOING;
-}
-
-int play(int combo) 
+void play(GameEngine& game) 
 {
-    printBoard();
-    if (currentPlayer == 1) 
-    {
-        std::cout << "Player 1's turn.\n";
-    }
-    else 
-    {
-        std::cout << "Player 2's turn.\n";
-    }
+    printBoard(game);
+    int player = game.getCurrentPlayer();
+    std::cout << "Player " << player << "'s turn.\n";
 
-    std::pair<int, int> gem1 = getUserInput("Enter first gem coordinates (row col): ");
-    std::pair<int, int> gem2 = getUserInput("Enter second gem coordinates (row col): ");
+    std::pair<int, int> gem1 = getUserInput("Enter first gem coordinates (row col): ", game);
+    std::pair<int, int> gem2 = getUserInput("Enter second gem coordinates (row col): ", game);
 
     std::cout << "Swapping gems at (" << gem1.first << ", " << gem1.second << ") and (" << gem2.first << ", " << gem2.second << ")\n";
 
-    if (isValidMove(gem1.first - 1, gem1.second - 1, gem2.first - 1, gem2.second - 1)) 
-    {
-        swapGems(gem1.first - 1, gem1.second - 1, gem2.first - 1, gem2.second - 1); 
-        printBoard(); 
-
-        if (matchGems(gem1.first - 1, gem1.second - 1) || matchGems(gem2.first - 1, gem2.second - 1)) 
-        {
-            if (currentPlayer == 1) 
-            {
-                removeMatches(player1, combo);
-            }
-            else 
-            {
-                removeMatches(player2, combo);
-            }
-            dropGems();
-            fillBoard();
-            if (!hasValidMoves()) 
-            {
-                std::cout << "No more valid moves. Reshuffling the board.\n";
-                makeBoard(8, 8);
-                printBoard();
-                combo = 1;
-            }
-            else 
-            {
-                combo++;
-            }
-
-        }
-        else 
-        {
-            swapGems(gem1.first - 1, gem1.second - 1, gem2.first - 1, gem2.second - 1);
-            std::cout << "No match formed! Try again.\n";
-            combo = 1;
-        }
-    }
-    else 
+    GameEngine::MoveResult result = game.applyMove(gem1.first - 1, gem1.second - 1, gem2.first - 1, gem2.second - 1);
+    if (result == GameEngine::MoveResult::INVALID) 
     {
         std::cout << "Invalid move. Try again.\n";
-        combo = 1;
     }
-
-    if (currentPlayer == 1) 
-    {
-        std::cout << "Player 1's current score: " << player1.score << std::endl;
-        currentPlayer = 2;
-    }
-    else 
+    else if (result == GameEngine::MoveResult::NO_MATCH) 
     {
-        std::cout << "Player 2's current score: " << player2.score << std::endl;
-        currentPlayer = 1;
+        std::cout << "No match formed! Try again.\n";
     }
-    return combo;
-}
-
-void swapGems(int row1, int col1, int row2, int col2, bool printMessage) { 
-    if (printMessage) 
+    else if (result == GameEngine::MoveResult::RESHUFFLED) 
     {
-        std::cout << "Swapping (" << row1 + 1 << ", " << col1 + 1 << ") with (" << row2 + 1 << ", " << col2 + 1 << ")\n";
+        std::cout << "No more valid moves. Reshuffling the board.\n";
+        printBoard(game);
     }
-    std::swap(board[row1][col1], board[row2][col2]);
-}
-
-bool matchGems(int row, int col) 
-{
-    if (board[row][col] == GemType::EMPTY) return false;
-    GemType gem = board[row][col];
-
-    int matchCount = 1, left = col - 1, right = col + 1;
-    while (left >= 0 && board[row][left] == gem) { matchCount++; left--; }
-    while (right < static_cast<int>(board.size()) && board[row][right] == gem) { matchCount++; right++; }
-    if (matchCount >= 3) return true;
-
-    matchCount = 1, left = row - 1, right = row + 1;
-    while (left >= 0 && board[left][col] == gem) { matchCount++; left--; }
-    while (right < static_cast<int>(board.size()) && board[right][col] == gem) { matchCount++; right++; }
-    return matchCount >= 3;
-}
-
-void removeMatches(Player& player, int combo) 
-{
-    for (int i = 0; i < static_cast<int>(board.size()); ++i) 
+    else 
     {
-        for (int j = 0; j < static_cast<int>(board.size()); ++j) 
-        {
-            if (matchGems(i, j)) 
-            {
-                player.score += calculatePoints(board[i][j]) * combo;
-                board[i][j] = GemType::EMPTY;
-            }
-        }
+        printBoard(game);
     }
-}
 
-void dropGems() {
-    for (int col = 0; col < static_cast<int>(board.size()); ++col) 
-    {
-        for (int row = static_cast<int>(board.size()) - 1; row >= 0; --row) 
-        {
-            if (board[row][col] == GemType::EMPTY) 
-            {
-                for (int above = row - 1; above >= 0; --above) 
-                {
-                    if (board[above][col] != GemType::EMPTY) 
-                    {
-                        board[row][col] = board[above][col];
-                        board[above][col] = GemType::EMPTY;
-                        break;
-                    }
-                }
-            }
-        }
-    }
+    std::cout << "Player " << player << "'s current score: " << game.getScore(player) << std::endl;
 }
 
-void fillBoard() 
-{
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distrib(1, 5);
-    for (int i = 0; i < static_cast<int>(board.size()); ++i) 
-    {
-        for (int j = 0; j < static_cast<int>(board.size()); ++j) 
-        {
-            if (board[i][j] == GemType::EMPTY) 
-            {
-                board[i][j] = static_cast<GemType>(distrib(gen));
-            }
-        }
-    }
-}
-
-std::pair<int, int> getUserInput(const std::string& prompt) 
+std::pair<int, int> getUserInput(const std::string& prompt, const GameEngine& game) 
 {
     int row, col;
     while (true) 
@@ -339,7 +205,7 @@ std::pair<int, int> getUserInput(const std::string& prompt)
         std::cout << prompt;
         if (std::cin >> row >> col) 
         {
-            if (row > 0 && row <= board.size() && col > 0 && col <= board.size()) 
+            if (game.inBounds(row - 1, col - 1)) 
             {
                 return { row, col };
             }
@@ -358,62 +224,137 @@ std::pair<int, int> getUserInput(const std::string& prompt)
     }
 }
 
-
-bool isValidMove(int row1, int col1, int row2, int col2) 
+// Result of replaying one move stream
+struct BatchResult 
 {
-    return (row1 == row2 && std::abs(col1 - col2) == 1) || (col1 == col2 && std::abs(row1 - row2) == 1);
-}
+    long long movesRead = 0;
+    long long movesRejected = 0; // Out of range moves
+    long long movesSkipped = 0; // Moves after the game ended
+    bool malformed = false;
+    long long errorLine = 0;
+    bool opened = true;
+};
 
-int calculatePoints(GemType gem) 
+// Replays "row1 col1 row2 col2" moves (1-based, like the prompts) on the given game without printing
+BatchResult replayMoves(GameEngine& game, std::FILE* input) 
 {
-    if (gem == GemType::RED_GEM) 
+    BatchResult result;
+    Match3::MoveReader reader(input);
+    int coords[4];
+
+    while (reader.nextMove(coords)) 
     {
-        return 300;
+        ++result.movesRead;
+
+        if (game.status() != GameState::ONGOING) 
+        {
+            ++result.movesSkipped;
+            continue;
+        }
+        if (!game.inBounds(coords[0] - 1, coords[1] - 1) || !game.inBounds(coords[2] - 1, coords[3] - 1)) 
+        {
+            ++result.movesRejected;
+            continue;
+        }
+        game.applyMove(coords[0] - 1, coords[1] - 1, coords[2] - 1, coords[3] - 1);
     }
-    else if (gem == GemType::GREEN_GEM) 
+    result.malformed = reader.isMalformed();
+    result.errorLine = reader.getLine();
+    return result;
+}
+
+void printBatchResult(const char* name, const GameEngine& game, const BatchResult& result) 
+{
+    if (!result.opened) 
     {
-        return 250;
+        std::fprintf(stderr, "Could not open move file: %s\n", name);
+        return;
     }
-    else if (gem == GemType::YELLOW_GEM) 
+    if (result.malformed) 
     {
-        return 200;
+        std::fprintf(stderr, "%s: malformed move input on line %lld\n", name, result.errorLine);
     }
-    else if (gem == GemType::BLUE_GEM) 
+    const char* status = "ONGOING";
+    if (game.status() == GameState::PLAYER_1_WINS) status = "PLAYER_1_WINS";
+    else if (game.status() == GameState::PLAYER_2_WINS) status = "PLAYER_2_WINS";
+    else if (game.status() == GameState::DRAW) status = "DRAW";
+
+    std::printf("%s\n", name);
+    std::printf("Moves read: %lld\n", result.movesRead);
+    std::printf("Moves rejected as out of range: %lld\n", result.movesRejected);
+    std::printf("Moves skipped after game end: %lld\n", result.movesSkipped);
+    std::printf("Status: %s\n", status);
+    std::printf("Player 1 Score: %d\n", game.getScore(1));
+    std::printf("Player 2 Score: %d\n", game.getScore(2));
+}
+
+// Replays each move file on its own 8x8 game dealt from seed, or stdin when no files (or "-") are given.
+// Files are handed out to a fixed set of worker threads; summaries are printed in argument order.
+// Returns the process exit code: 0 on success, 1 if any input was missing or malformed.
+// stdin can only be read once, so "-" may be given at most once.
+int runBatch(int fileCount, char* files[], unsigned int seed) 
+{
+    auto start = std::chrono::steady_clock::now();
+    const char* stdinName = "-";
+    int stdinCount = 0;
+    for (int i = 0; i < fileCount; ++i) 
     {
-        return 150;
+        if (std::strcmp(files[i], stdinName) == 0) stdinCount++;
     }
-    else if (gem == GemType::MAGENTA_GEM) 
+    if (stdinCount > 1) 
     {
-        return 100;
+        std::fprintf(stderr, "stdin (\"-\") can only be given once\n");
+        return 1;
     }
-    else 
+    int gameCount = fileCount > 0 ? fileCount : 1;
+
+    std::vector<GameEngine> games;
+    games.reserve(gameCount);
+    for (int i = 0; i < gameCount; ++i) 
     {
-        return 0;
+        games.emplace_back(8, 8, seed);
     }
-}
+    std::vector<BatchResult> results(gameCount);
 
-bool hasValidMoves() {
-    for (int i = 0; i < static_cast<int>(board.size()); ++i) 
+    std::atomic<int> nextGame(0);
+    auto worker = [&]() 
     {
-        for (int j = 0; j < static_cast<int>(board.size()); ++j) 
+        for (int i = nextGame++; i < gameCount; i = nextGame++) 
         {
-            if (board[i][j] != GemType::EMPTY) 
+            const char* name = fileCount > 0 ? files[i] : stdinName;
+            std::FILE* input = std::strcmp(name, "-") == 0 ? stdin : std::fopen(name, "rb");
+            if (!input) 
             {
-                // Check adjacent gems for potential matches
-                if (j > 0 && board[i][j - 1] != GemType::EMPTY && (board[i][j] == board[i][j - 1] || checkPotentialMatch(i, j, i, j - 1))) return true;
-                if (j < static_cast<int>(board.size()) - 1 && board[i][j + 1] != GemType::EMPTY && (board[i][j] == board[i][j + 1] || checkPotentialMatch(i, j, i, j + 1))) return true;
-                if (i > 0 && board[i - 1][j] != GemType::EMPTY && (board[i][j] == board[i - 1][j] || checkPotentialMatch(i, j, i - 1, j))) return true;
-                if (i < static_cast<int>(board.size()) - 1 && board[i + 1][j] != GemType::EMPTY && (board[i][j] == board[i + 1][j] || checkPotentialMatch(i, j, i + 1, j))) return true;
+                results[i].opened = false;
+                continue;
             }
+            results[i] = replayMoves(games[i], input);
+            if (input != stdin) std::fclose(input);
         }
+    };
+
+    unsigned int threadCount = std::max(1u, std::min(std::thread::hardware_concurrency(), static_cast<unsigned int>(gameCount)));
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threadCount; ++t) 
+    {
+        workers.emplace_back(worker);
     }
-    return false;
-}
+    worker();
+    for (auto& thread : workers) 
+    {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-bool checkPotentialMatch(int row1, int col1, int row2, int col2) 
-{
-    swapGems(row1, col1, row2, col2, false); 
-    bool match = matchGems(row1, col1) || matchGems(row2, col2);
-    swapGems(row1, col1, row2, col2, false); 
-    return match;
-}
\ No newline at end of file
+    int exitCode = 0;
+    long long totalMoves = 0;
+    for (int i = 0; i < gameCount; ++i) 
+    {
+        printBatchResult(fileCount > 0 ? files[i] : stdinName, games[i], results[i]);
+        totalMoves += results[i].movesRead;
+        if (!results[i].opened || results[i].malformed) exitCode = 1;
+    }
+    std::printf("Games: %d, seed: %u, time: %.3f s (%.0f moves/s)\n", gameCount, seed, seconds,
+        seconds > 0.0 ? totalMoves / seconds : 0.0);
+    return exitCode;
+}
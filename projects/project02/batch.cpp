@@ -0,0 +1,76 @@
+#include "batch.h"
+#include <chrono>
+#include "../common/move_reader.h"
+
+namespace 
+{
+    const char* statusName(Game::Status status) 
+    {
+        switch (status) 
+        {
+        case Game::PLAYER_1_WINS: return "PLAYER_1_WINS";
+        case Game::PLAYER_2_WINS: return "PLAYER_2_WINS";
+        case Game::DRAW: return "DRAW";
+        default: return "ONGOING";
+        }
+    }
+}
+
+bool runBatch(Game& game, std::FILE* input, BatchSummary& summary) 
+{
+    auto start = std::chrono::steady_clock::now();
+    Match3::MoveReader reader(input);
+    int coords[4];
+
+    while (reader.nextMove(coords)) 
+    {
+        ++summary.movesRead;
+
+        if (game.status() != Game::ONGOING) 
+        {
+            ++summary.movesSkipped;
+            continue;
+        }
+
+        bool inRange = true;
+        for (int i = 0; i < 4; ++i) 
+        {
+            int limit = (i % 2 == 0) ? game.getRows() : game.getCols();
+            if (coords[i] < 1 || coords[i] > limit) inRange = false;
+        }
+        if (inRange && game.play(coords[0] - 1, coords[1] - 1, coords[2] - 1, coords[3] - 1)) 
+        {
+            ++summary.movesApplied;
+        }
+        else 
+        {
+            ++summary.movesRejected;
+        }
+    }
+
+    if (reader.isMalformed()) 
+    {
+        summary.malformed = true;
+        summary.errorLine = reader.getLine();
+    }
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return !summary.malformed;
+}
+
+void printBatchSummary(const Game& game, const BatchSummary& summary) 
+{
+    if (summary.malformed) 
+    {
+        std::fprintf(stderr, "Malformed move input on line %lld\n", summary.errorLine);
+    }
+    std::printf("Seed: %u\n", summary.seed);
+    std::printf("Moves read: %lld\n", summary.movesRead);
+    std::printf("Moves applied: %lld\n", summary.movesApplied);
+    std::printf("Moves rejected: %lld\n", summary.movesRejected);
+    std::printf("Moves skipped after game end: %lld\n", summary.movesSkipped);
+    std::printf("Status: %s\n", statusName(game.status()));
+    std::printf("Player 1 Score: %d\n", game.getPlayerScore(1));
+    std::printf("Player 2 Score: %d\n", game.getPlayerScore(2));
+    double movesPerSecond = summary.seconds > 0.0 ? summary.movesRead / summary.seconds : 0.0;
+    std::printf("Time: %.3f s (%.0f moves/s)\n", summary.seconds, movesPerSecond);
+}
@@ -0,0 +1,29 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstdio>
+#include "game.h"
+
+// Counts gathered while replaying a move file
+struct BatchSummary 
+{
+    long long movesRead = 0; // Complete moves parsed from the input
+    long long movesApplied = 0; // Moves that formed a match
+    long long movesRejected = 0; // Moves that were out of range, not adjacent or formed no match
+    long long movesSkipped = 0; // Moves left over after the game ended
+    double seconds = 0.0; // Wall time spent parsing and playing
+    bool malformed = false; // Input contained something other than numbers and comments
+    long long errorLine = 0; // Line of the first malformed token
+    unsigned int seed = 0; // Seed the game was dealt from, printed so the run can be repeated
+};
+
+// Replays moves from input without printing the board.
+// Moves are whitespace separated groups of "row1 col1 row2 col2" using 1-based coordinates
+// like the interactive prompt, and '#' starts a comment that runs to the end of the line.
+// Returns false if the input was malformed; moves before the bad token are still applied.
+bool runBatch(Game& game, std::FILE* input, BatchSummary& summary);
+
+// Prints the final status, scores and throughput of a batch run
+void printBatchSummary(const Game& game, const BatchSummary& summary);
+
+#endif // BATCH_H
@@ -1,8 +1,9 @@
 #ifndef GAME_H
 #define GAME_H
 
-#include <vector>
 #include <iostream>
+#include <random>
+#include "../common/match3_scoring.h"
 
 class Game 
 {
@@ -12,11 +13,15 @@ public:
     // Enumeration for gem types
     enum GemType { EMPTY, RED_GEM, GREEN_GEM, YELLOW_GEM, BLUE_GEM, MAGENTA_GEM };
 
-    // Constructor: Initializes the game board and player scores
-    Game(int rows = 8, int cols = 8);
+    // Gem values times the combo, retunable from a score file (see match3_scoring.h)
+    typedef Match3::TunableScoring<Match3::GemValueScoring> Scoring;
+
+    // Constructor: Initializes the game board and player scores; the seed makes the gem sequence reproducible
+    Game(int rows = 8, int cols = 8, unsigned int seed = std::random_device{}());
 
     // Plays a move: Swaps gems and updates game state
-    void play(int row1, int col1, int row2, int col2);
+    // Returns true if the swap was kept because it formed a match
+    bool play(int row1, int col1, int row2, int col2);
 
     // Returns the current game status
     Status status() const;
@@ -24,28 +29,29 @@ public:
     // Displays the game board to the console
     void display() const;
 
+    // Accessors used by the renderers
+    int getRows() const { return board.rows(); }
+    int getCols() const { return board.cols(); }
+    GemType getGem(int row, int col) const { return board[row][col]; }
+    int getPlayerScore(int player) const { return player == 1 ? player1Score : player2Score; }
+
     // Overloads the << operator to print the game board
     friend std::ostream& operator<<(std::ostream& os, const Game& game);
 
 private:
-    std::vector<std::vector<GemType>> board; // 2D vector for the game board
+    typedef Match3::GridBoard<GemType> Board;
+    typedef Match3::Rules<Board, Scoring> Rules; // Match, drop and refill rules shared with project01 and project04
+
+    Board board; // Game board, row by row
     int currentPlayer; // Tracks the current player's turn
     int player1Score; // Player 1's score
     int player2Score; // Player 2's score
     int combo; // Tracks the current combo multiplier
-    int rows; // Number of rows in the board
-    int cols; // Number of columns in the board
+    std::mt19937 gen; // Seeded once per game, not on every fill
+    std::uniform_int_distribution<int> gemDistribution; // Gem types 1-5
 
     // Helper functions
-    void makeBoard(); // Initializes the game board with random gems
-    bool isValidMove(int row1, int col1, int row2, int col2); // Checks if a move is valid
-    bool matchGems(int row, int col); // Checks if a gem has a match
-    void removeMatches(int player, int combo); // Removes matched gems and updates score
-    void dropGems(); // Drops gems to fill empty spaces
-    void fillBoard(); // Fills empty spaces with new random gems
-    int calculatePoints(GemType gem); // Calculates points based on gem type
-    bool hasValidMoves(); // Checks if there are any valid moves left
-    bool checkPotentialMatch(int row1, int col1, int row2, int col2); // Checks for potential matches
+    void makeBoard(); // Deals a board with no matches and at least one valid move
 };
 
 #endif // GAME_H
\ No newline at end of file
@@ -1,18 +1,78 @@
 #include "game.h"
+#include "renderer.h"
 #include <iostream>
 #include <limits>
+#include <cstdio>
+#include <cstring>
+#include "batch.h"
+#include "../common/move_reader.h"
+#include "../common/match3_bench.h"
 
 
-int main() 
+// Usage: project02 --batch [--seed N] [movefile] | project02 --bench
+// Batch mode replays moves from the file (or stdin) without drawing and prints a summary; the board
+// is dealt from the given seed, or from a random one that the summary prints so the run can be repeated
+// Bench mode times the shared match-3 rules on Game's board storage and scoring
+// Interactive play rereads scores.cfg (see match3_scoring.h) before a turn whenever it changes
+int main(int argc, char* argv[]) 
 {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) 
+    {
+        Match3::benchmarkGridSizes<Game::GemType, Game::Scoring>("project02 Game");
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--batch") == 0) 
+    {
+        int first = 2;
+        unsigned int seed = std::random_device{}();
+        if (argc > 2 && std::strcmp(argv[2], "--seed") == 0) 
+        {
+            if (argc < 4 || !Match3::parseSeed(argv[3], seed)) 
+            {
+                std::cerr << "--seed needs a number from 0 to 4294967295" << std::endl;
+                return 1;
+            }
+            first = 4;
+        }
+        std::FILE* input = stdin;
+        if (argc > first && std::strcmp(argv[first], "-") != 0) 
+        {
+            input = std::fopen(argv[first], "rb");
+            if (!input) 
+            {
+                std::cerr << "Could not open move file: " << argv[first] << std::endl;
+                return 1;
+            }
+        }
+        Game batchGame(8, 8, seed);
+        BatchSummary summary;
+        summary.seed = seed;
+        bool ok = runBatch(batchGame, input, summary);
+        if (input != stdin) std::fclose(input);
+        printBatchSummary(batchGame, summary);
+        return ok ? 0 : 1;
+    }
+
     Game game;
+    TerminalRenderer renderer;
+    Match3::ScoreFileWatcher<Game::Scoring> scoreWatcher("scores.cfg"); // Optional, reread before a turn when it changes
     bool playAgain = true;
 
     while (playAgain) 
     {
         while (game.status() == Game::Status::ONGOING) 
         {
-            std::cout << game;
+            std::string scoreError;
+            bool scoresLoaded = scoreWatcher.poll(scoreError);
+            renderer.draw(game); // Clears everything below the frame, so messages come after it
+            if (scoresLoaded) 
+            {
+                std::cout << "Loaded new scores from scores.cfg\n";
+            }
+            else if (!scoreError.empty()) 
+            {
+                std::cout << "Kept the previous scores: " << scoreError << "\n";
+            }
             int row1, col1, row2, col2;
             while (true) 
             {
@@ -70,6 +130,7 @@ int main()
         else 
         {
             game = Game();
+            renderer.invalidate();
         }
     }
     return 0;
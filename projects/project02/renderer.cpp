@@ -0,0 +1,187 @@
+#include "renderer.h"
+#include <cstdio>
+
+namespace 
+{
+    // Terminal color and letter for each gem type, indexed by Game::GemType
+    const char* const GEM_COLORS[] = { "", "\033[31m", "\033[32m", "\033[33m", "\033[34m", "\033[35m" };
+    const char GEM_LETTERS[] = { '.', 'R', 'G', 'Y', 'B', 'P' };
+    const char* const RESET = "\033[0m";
+
+    const int ROW_LABEL_WIDTH = 5; // "%3d  " in front of every row
+    const int CELL_WIDTH = 6; // Letter right-aligned in 5 columns plus a space
+
+    // Appends value right-aligned in width columns, like std::setw
+    void appendNumber(std::string& buffer, int value, int width = 0) 
+    {
+        char digits[12];
+        int length = std::snprintf(digits, sizeof(digits), "%d", value);
+        for (int pad = length; pad < width; ++pad) 
+        {
+            buffer += ' ';
+        }
+        buffer.append(digits, length);
+    }
+
+    // Appends the escape sequence that moves the cursor to a 1-based line and column
+    void appendCursorMove(std::string& buffer, int line, int column) 
+    {
+        buffer += "\033[";
+        appendNumber(buffer, line);
+        buffer += ';';
+        appendNumber(buffer, column);
+        buffer += 'H';
+    }
+
+    // Appends a color change only if it differs from the color currently active
+    void appendColor(std::string& buffer, Game::GemType gem, Game::GemType& activeColor) 
+    {
+        if (gem == activeColor) return;
+        buffer += (gem == Game::EMPTY) ? RESET : GEM_COLORS[gem];
+        activeColor = gem;
+    }
+
+    void appendScoreLine(std::string& buffer, int player, int score) 
+    {
+        buffer += "Player ";
+        appendNumber(buffer, player);
+        buffer += " Score: ";
+        appendNumber(buffer, score);
+    }
+}
+
+TerminalRenderer::TerminalRenderer() : previousRows(0), previousCols(0), previousScore1(0), previousScore2(0), hasPreviousFrame(false) 
+{
+}
+
+void TerminalRenderer::draw(const Game& game) 
+{
+    buffer.clear();
+    if (!hasPreviousFrame || game.getRows() != previousRows || game.getCols() != previousCols) 
+    {
+        drawFull(game);
+    }
+    else 
+    {
+        drawChanges(game);
+    }
+    // Leave the cursor on the line below the frame with the rest of the screen cleared for prompts
+    appendCursorMove(buffer, game.getRows() + 4, 1);
+    buffer += "\033[J";
+    flush();
+    rememberFrame(game);
+}
+
+void TerminalRenderer::invalidate() 
+{
+    hasPreviousFrame = false;
+}
+
+void TerminalRenderer::composeFrame(const Game& game, std::string& buffer) 
+{
+    const int rows = game.getRows();
+    const int cols = game.getCols();
+    buffer.reserve(buffer.size() + (rows + 1) * (ROW_LABEL_WIDTH + cols * (CELL_WIDTH + 5) + 1) + 64);
+
+    buffer += "     ";
+    for (int j = 0; j < cols; ++j) 
+    {
+        appendNumber(buffer, j + 1, 5);
+        buffer += ' ';
+    }
+    buffer += '\n';
+
+    Game::GemType activeColor = Game::EMPTY;
+    for (int i = 0; i < rows; ++i) 
+    {
+        appendNumber(buffer, i + 1, 3);
+        buffer += "  ";
+        for (int j = 0; j < cols; ++j) 
+        {
+            Game::GemType gem = game.getGem(i, j);
+            buffer += "    ";
+            appendColor(buffer, gem, activeColor);
+            buffer += GEM_LETTERS[gem];
+            buffer += ' ';
+        }
+        appendColor(buffer, Game::EMPTY, activeColor); // Row labels are never colored
+        buffer += '\n';
+    }
+    appendScoreLine(buffer, 1, game.getPlayerScore(1));
+    buffer += '\n';
+    appendScoreLine(buffer, 2, game.getPlayerScore(2));
+    buffer += '\n';
+}
+
+void TerminalRenderer::drawFull(const Game& game) 
+{
+    buffer += "\033[H\033[2J";
+    composeFrame(game, buffer);
+}
+
+void TerminalRenderer::drawChanges(const Game& game) 
+{
+    const int rows = game.getRows();
+    const int cols = game.getCols();
+    Game::GemType activeColor = Game::EMPTY;
+
+    for (int i = 0; i < rows; ++i) 
+    {
+        int cursorCol = -1; // Column the cursor sits on after the last write in this row, -1 if unknown
+        for (int j = 0; j < cols; ++j) 
+        {
+            Game::GemType gem = game.getGem(i, j);
+            if (gem == previousCells[i * cols + j]) continue;
+
+            // Consecutive changed cells only need the spacing between them, not a new cursor move
+            if (cursorCol == j) 
+            {
+                buffer += "     ";
+            }
+            else 
+            {
+                appendCursorMove(buffer, i + 2, ROW_LABEL_WIDTH + j * CELL_WIDTH + 5);
+            }
+            appendColor(buffer, gem, activeColor);
+            buffer += GEM_LETTERS[gem];
+            cursorCol = j + 1;
+        }
+    }
+    appendColor(buffer, Game::EMPTY, activeColor);
+
+    if (game.getPlayerScore(1) != previousScore1) 
+    {
+        appendCursorMove(buffer, rows + 2, 1);
+        buffer += "\033[2K";
+        appendScoreLine(buffer, 1, game.getPlayerScore(1));
+    }
+    if (game.getPlayerScore(2) != previousScore2) 
+    {
+        appendCursorMove(buffer, rows + 3, 1);
+        buffer += "\033[2K";
+        appendScoreLine(buffer, 2, game.getPlayerScore(2));
+    }
+}
+
+void TerminalRenderer::rememberFrame(const Game& game) 
+{
+    previousRows = game.getRows();
+    previousCols = game.getCols();
+    previousCells.resize(previousRows * previousCols);
+    for (int i = 0; i < previousRows; ++i) 
+    {
+        for (int j = 0; j < previousCols; ++j) 
+        {
+            previousCells[i * previousCols + j] = game.getGem(i, j);
+        }
+    }
+    previousScore1 = game.getPlayerScore(1);
+    previousScore2 = game.getPlayerScore(2);
+    hasPreviousFrame = true;
+}
+
+void TerminalRenderer::flush() 
+{
+    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+    std::fflush(stdout);
+}
@@ -0,0 +1,40 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <string>
+#include <vector>
+#include "game.h"
+
+// Draws a Game to an ANSI terminal.
+// Each frame is composed into one reused buffer and written out in a single call.
+// After the first frame only the cells and score lines that changed are rewritten.
+class TerminalRenderer 
+{
+public:
+    TerminalRenderer();
+
+    // Draws the game, only rewriting what changed since the previous draw
+    void draw(const Game& game);
+
+    // Forces the next draw to clear the screen and repaint everything
+    void invalidate();
+
+    // Appends a complete frame (header, board and scores) to buffer without any cursor movement
+    static void composeFrame(const Game& game, std::string& buffer);
+
+private:
+    std::string buffer; // Output buffer, cleared but never shrunk between frames
+    std::vector<Game::GemType> previousCells; // Board as it was last drawn, row-major
+    int previousRows; // Board size of the last drawn frame
+    int previousCols;
+    int previousScore1; // Scores of the last drawn frame
+    int previousScore2;
+    bool hasPreviousFrame; // False until a full frame has been drawn
+
+    void drawFull(const Game& game); // Clears the screen and draws the whole frame
+    void drawChanges(const Game& game); // Moves the cursor to and rewrites only changed cells
+    void rememberFrame(const Game& game); // Copies the drawn state for the next diff
+    void flush(); // Writes the buffer to stdout in one call
+};
+
+#endif // RENDERER_H
@@ -1,6 +1,7 @@
 // game.cpp
 
 #include "Game.h" // Include Game.h first
+#include "snapshot.h"
 #include <cstdlib>
 #include <ctime>
 #include <algorithm>
@@ -14,27 +15,28 @@ void PlayGemMatchSound(Game::GemType gemType);
 
 // Note: MatchInfo struct is now in Game.h
 
-Game::Game() : m_isCascading(false), m_isDropping(false), m_isRefilling(false), // Initialize new members
-dropAnimationProgress(0.0f), selectedRow(-1), selectedCol(-1),
-swapAnimationProgress(0.0f), m_isAnimating(false),
+// Draws gem types 1-5 for the shared rules from the C library generator seeded in Game()
+static int randomGem() {
+    return 1 + std::rand() % Match3::GEM_KINDS;
+}
+
+Game::Game() : board(GRID_SIZE, GRID_SIZE), phase(Phase::IDLE), timeline(GRID_SIZE * GRID_SIZE), // Every cell moves at most once at a time
+selectedRow(-1), selectedCol(-1),
 player1Score(0), player2Score(0), movesLeft(MAX_MOVES),
-currentStatus(ONGOING), currentPlayer(PLAYER_1) {
+currentStatus(ONGOING), currentPlayer(PLAYER_1), showHint(false), hintTime(0.0f) {
+    hints.resize(GRID_SIZE, GRID_SIZE);
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
     reset();
 }
 
 void Game::reset() {
-    board.assign(GRID_SIZE, std::vector<GemType>(GRID_SIZE, EMPTY)); // Use assign to resize and initialize
     selectedRow = -1;
     selectedCol = -1;
-    swapAnimationProgress = 0.0f;
-    m_isAnimating = false;
-    m_isCascading = false;
-    m_isDropping = false;
-    m_isRefilling = false;
-    dropAnimationProgress = 0.0f;
-    droppedGems.clear();
-    gemDropStartRow.assign(GRID_SIZE, std::vector<int>(GRID_SIZE, -1)); // Reset drop start rows
+    phase = Phase::IDLE;
+    timeline.clear();
+    particles.clear();
+    swapR1 = swapC1 = swapR2 = swapC2 = -1;
+    cascadeDepth = 0;
 
     currentPlayer = PLAYER_1;
     player1Score = 0;
@@ -46,21 +48,9 @@ void Game::reset() {
 }
 
 void Game::initializeBoard() {
-    // Fill the board with random gems, ensuring no immediate matches
-    for (int r = 0; r < GRID_SIZE; ++r) {
-        for (int c = 0; c < GRID_SIZE; ++c) {
-            GemType type;
-            do {
-                type = static_cast<GemType>(1 + std::rand() % 5); // Assign random gem type (1-5)
-            } while (
-                // Check for vertical match above
-                ((r >= 2 && board[r - 1][c] != EMPTY && board[r - 1][c] == type && board[r - 2][c] == type) ||
-                    // Check for horizontal match left
-                    (c >= 2 && board[r][c - 1] != EMPTY && board[r][c - 1] == type && board[r][c - 2] == type))
-                );
-            board[r][c] = type;
-        }
-    }
+    // Random gems with no match already on the board and at least one valid move
+    Rules::deal(board, randomGem);
+    hints.boardChanged();
 }
 
 // Function definition for setSelectedGem - ADDED
@@ -70,8 +60,7 @@ void Game::setSelectedGem(int row, int col) {
 }
 
 void Game::play(int r1, int c1, int r2, int c2) {
-    if (m_isAnimating || m_isCascading || m_isDropping || m_isRefilling || !isValidSwap(r1, c1, r2, c2) ||
-        !checkPotentialMatch(r1, c1, r2, c2)) {
+    if (phase != Phase::IDLE || !Rules::isValidMove(board, r1, c1, r2, c2)) {
         selectedRow = -1; // Deselect if the play is invalid
         selectedCol = -1;
         return;
@@ -82,119 +71,168 @@ void Game::play(int r1, int c1, int r2, int c2) {
     swapC1 = c1;
     swapR2 = r2;
     swapC2 = c2;
-    swapAnimationProgress = 0.0f;
-    m_isAnimating = true;
-
-    m_isCascading = false; // Reset cascading on a new player initiated swap
-    m_isDropping = false; // Ensure dropping is false at the start of a new play
-    m_isRefilling = false; // Ensure refilling is false
+    cascadeDepth = 0;
+    animateSwap(r1, c1, r2, c2);
+    phase = Phase::SWAPPING;
 
     selectedRow = -1; // Deselect gems when a swap is initiated
     selectedCol = -1;
 }
 
-void Game::animateSwap(int r1, int c1, int r2, int c2) {
-    // Animation logic handled in update()
-    // This function is called internally within play, but the animation progress is tracked in update
+void Game::saveSnapshot(GameSnapshot& snapshot) const {
+    snapshot.magic = GameSnapshot::MAGIC;
+    snapshot.version = GameSnapshot::VERSION;
+    for (int r = 0; r < GRID_SIZE; ++r) {
+        for (int c = 0; c < GRID_SIZE; ++c) {
+            snapshot.board[r * GRID_SIZE + c] = static_cast<uint8_t>(board[r][c]);
+        }
+    }
+    snapshot.player1Score = player1Score;
+    snapshot.player2Score = player2Score;
+    snapshot.movesLeft = movesLeft;
+    snapshot.currentPlayer = static_cast<uint8_t>(currentPlayer);
+    snapshot.status = static_cast<uint8_t>(currentStatus);
+    snapshot.phase = static_cast<uint8_t>(phase);
+    snapshot.selectedRow = static_cast<int8_t>(selectedRow);
+    snapshot.selectedCol = static_cast<int8_t>(selectedCol);
+    snapshot.swapR1 = static_cast<int8_t>(swapR1);
+    snapshot.swapC1 = static_cast<int8_t>(swapC1);
+    snapshot.swapR2 = static_cast<int8_t>(swapR2);
+    snapshot.swapC2 = static_cast<int8_t>(swapC2);
+    snapshot.cascadeDepth = static_cast<uint8_t>(std::min(cascadeDepth, 255));
+    snapshot.reserved = 0;
+
+    snapshot.timelineTime = timeline.now();
+    snapshot.tweenCount = static_cast<uint8_t>(timeline.size());
+    for (int i = 0; i < timeline.size(); ++i) {
+        const Tween& tween = timeline.at(i);
+        SnapshotTween& saved = snapshot.tweens[i];
+        saved.row = static_cast<int8_t>(tween.row);
+        saved.col = static_cast<int8_t>(tween.col);
+        saved.easing = static_cast<uint8_t>(tween.easing);
+        saved.reserved = 0;
+        saved.fromRow = tween.fromRow;
+        saved.fromCol = tween.fromCol;
+        saved.toRow = tween.toRow;
+        saved.toCol = tween.toCol;
+        saved.startTime = tween.startTime;
+        saved.duration = tween.duration;
+    }
+    for (int i = timeline.size(); i < GameSnapshot::MAX_TWEENS; ++i) {
+        snapshot.tweens[i] = SnapshotTween(); // Keeps file contents and checksums deterministic
+    }
+    snapshot.checksum = 0;
 }
 
-void Game::update(float deltaTime) {
-    if (m_isAnimating) {
-        swapAnimationProgress += deltaTime * 4.0f; // Speed of swap animation
-        if (swapAnimationProgress >= 1.0f) {
-            swapGems(swapR1, swapC1, swapR2, swapC2);
-
-            // After swapping, check for matches (in the swap animation section)
-            MatchInfo matchInfo = clearMatches();
-            if (matchInfo.totalCleared > 0) {
-                addScore(matchInfo.totalCleared);
-                m_isAnimating = false; // End swap animation
-                m_isCascading = true; // Start cascading process
-                m_isDropping = true; // Immediately start dropping if matches were cleared
-                dropGems(); // Initiate the drop
-
-                // Play sounds for each gem type matched
-                for (int type : matchInfo.gemTypesMatched) {
-                    // Ensure the type is valid before playing sound
-                    if (type >= RED_GEM && type <= MAGENTA_GEM) {
-                        PlayGemMatchSound(static_cast<Game::GemType>(type)); // Cast back to GemType
-                    }
-                }
-            }
-            else {
-                // If no match, swap back
-                swapGems(swapR1, swapC1, swapR2, swapC2);
-                m_isAnimating = false; // End swap animation
-                endTurn(); // End the turn if no match
-            }
-            swapAnimationProgress = 0.0f; // Reset animation progress
-            // selectedRow and selectedCol are already reset in play() or endTurn()
-        }
+bool Game::restoreSnapshot(const GameSnapshot& snapshot) {
+    // Check everything first so a bad snapshot cannot leave a half-restored game
+    if (snapshot.magic != GameSnapshot::MAGIC || snapshot.version != GameSnapshot::VERSION ||
+        snapshot.currentPlayer > PLAYER_2 || snapshot.status > LOSE || snapshot.phase > static_cast<uint8_t>(Phase::FALLING) ||
+        snapshot.tweenCount > GameSnapshot::MAX_TWEENS || snapshot.movesLeft < 0 || snapshot.movesLeft > MAX_MOVES) {
+        return false;
     }
-    else if (m_isCascading) {
-        if (m_isDropping) {
-            dropAnimationProgress += deltaTime * 4.0f; // Speed of drop animation
-            if (dropAnimationProgress >= 1.0f) {
-                m_isDropping = false; // End dropping animation
-                m_isRefilling = true; // Move to refilling state
-                refillBoard(); // Refill happens instantly
-                dropAnimationProgress = 0.0f; // Reset drop animation progress
-                droppedGems.clear(); // Clear dropped gems list after animation
-                gemDropStartRow.assign(GRID_SIZE, std::vector<int>(GRID_SIZE, -1)); // Reset drop start rows
-            }
-        }
-        else if (m_isRefilling) {
-            m_isRefilling = false; // End refilling state
-
-            // After refilling, check for new matches
-            MatchInfo matchInfo = clearMatches();
-            if (matchInfo.totalCleared > 0) {
-                addScore(matchInfo.totalCleared);
-                m_isCascading = true; // Continue cascading
-                m_isDropping = true; // Start dropping for the next cascade
-                dropGems(); // Initiate the next drop
-
-                // Play sounds for each gem type matched
-                for (int type : matchInfo.gemTypesMatched) {
-                    // Ensure the type is valid before playing sound
-                    if (type >= RED_GEM && type <= MAGENTA_GEM) {
-                        PlayGemMatchSound(static_cast<Game::GemType>(type)); // Cast back to GemType
-                    }
-                }
-            }
-            else {
-                m_isCascading = false; // End cascading if no more matches
-                endTurn(); // End the turn
-            }
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; ++i) {
+        if (snapshot.board[i] > MAGENTA_GEM) return false;
+    }
+    for (int i = 0; i < snapshot.tweenCount; ++i) {
+        const SnapshotTween& saved = snapshot.tweens[i];
+        if (saved.row < 0 || saved.row >= GRID_SIZE || saved.col < 0 || saved.col >= GRID_SIZE ||
+            saved.easing > static_cast<uint8_t>(Easing::EASE_OUT_QUAD)) {
+            return false;
         }
-        else {
-            // If not dropping or refilling but still in cascading state,
-            // this means a cascade just finished, check for new matches immediately.
-            MatchInfo matchInfo = clearMatches();
-            if (matchInfo.totalCleared > 0) {
-                addScore(matchInfo.totalCleared);
-                m_isDropping = true; // Start dropping for the next cascade
-                dropGems(); // Initiate the next drop
-
-                // Play sounds for each gem type matched
-                for (int type : matchInfo.gemTypesMatched) {
-                    // Ensure the type is valid before playing sound
-                    if (type >= RED_GEM && type <= MAGENTA_GEM) {
-                        PlayGemMatchSound(static_cast<Game::GemType>(type)); // Cast back to GemType
-                    }
-                }
-            }
-            else {
-                m_isCascading = false; // End cascading if no more matches
-                endTurn(); // End the turn
-            }
+    }
+    if (snapshot.phase == static_cast<uint8_t>(Phase::SWAPPING) &&
+        !isValidSwap(snapshot.swapR1, snapshot.swapC1, snapshot.swapR2, snapshot.swapC2)) {
+        return false; // Settling the swap reads these cells
+    }
+
+    for (int r = 0; r < GRID_SIZE; ++r) {
+        for (int c = 0; c < GRID_SIZE; ++c) {
+            board[r][c] = static_cast<GemType>(snapshot.board[r * GRID_SIZE + c]);
         }
     }
+    hints.boardChanged();
+    player1Score = snapshot.player1Score;
+    player2Score = snapshot.player2Score;
+    movesLeft = snapshot.movesLeft;
+    currentPlayer = static_cast<Player>(snapshot.currentPlayer);
+    currentStatus = static_cast<GameStatus>(snapshot.status);
+    phase = static_cast<Phase>(snapshot.phase);
+    bool selectionValid = snapshot.selectedRow >= 0 && snapshot.selectedRow < GRID_SIZE &&
+        snapshot.selectedCol >= 0 && snapshot.selectedCol < GRID_SIZE;
+    selectedRow = selectionValid ? snapshot.selectedRow : -1;
+    selectedCol = selectionValid ? snapshot.selectedCol : -1;
+    swapR1 = snapshot.swapR1;
+    swapC1 = snapshot.swapC1;
+    swapR2 = snapshot.swapR2;
+    swapC2 = snapshot.swapC2;
+    cascadeDepth = snapshot.cascadeDepth;
+
+    timeline.clear(snapshot.timelineTime);
+    for (int i = 0; i < snapshot.tweenCount; ++i) {
+        const SnapshotTween& saved = snapshot.tweens[i];
+        timeline.add({ saved.row, saved.col, saved.fromRow, saved.fromCol, saved.toRow, saved.toCol,
+            saved.startTime, saved.duration, static_cast<Easing>(saved.easing) });
+    }
+    particles.clear();
+    return true;
+}
+
+// Swaps the gems in the board right away and tweens each one from its old cell to its new one
+void Game::animateSwap(int r1, int c1, int r2, int c2) {
+    swapGems(r1, c1, r2, c2);
+    float start = timeline.now();
+    timeline.add({ r2, c2, float(r1), float(c1), float(r2), float(c2), start, SWAP_DURATION, Easing::LINEAR });
+    timeline.add({ r1, c1, float(r2), float(c2), float(r1), float(c1), start, SWAP_DURATION, Easing::LINEAR });
+}
+
+void Game::update(float deltaTime) {
+    particles.update(deltaTime);
+    hintTime += deltaTime;
+    timeline.advance(deltaTime);
+    if (phase == Phase::IDLE || !timeline.isIdle()) {
+        return; // Nothing to resolve until every moving gem has landed
+    }
+
+    // The swap has landed, or the last cascade has settled: look for matches
+    MatchInfo matchInfo = clearMatches();
+    if (matchInfo.totalCleared > 0) {
+        addScore(matchInfo.points);
+        cascadeDepth++;
+        playMatchSounds(matchInfo); // Play sounds for each gem type matched
+        startFall();
+        phase = Phase::FALLING;
+    }
+    else if (phase == Phase::SWAPPING) {
+        // If no match, swap back
+        animateSwap(swapR1, swapC1, swapR2, swapC2);
+        phase = Phase::FALLING; // Settles without matches next time, which ends the turn
+    }
+    else {
+        phase = Phase::IDLE; // End cascading if no more matches
+        endTurn(); // End the turn
+    }
+}
+
+// Drops the remaining gems and refills the board in one step, so falling gems and new
+// gems move together column by column instead of one after the other. Every gem that moves
+// is tweened from its old row; new gems fall in from above the board.
+void Game::startFall() {
+    float start = timeline.now();
+    const int* fall = Rules::drop(board, [this, start](int fromRow, int toRow, int col) {
+        hints.cellChanged(fromRow, col);
+        hints.cellChanged(toRow, col);
+        timeline.add({ toRow, col, float(fromRow), float(col), float(toRow), float(col), start, FALL_DURATION, Easing::EASE_IN_QUAD });
+    });
+    Rules::refill(board, fall, randomGem, [this, start](int row, int col, int fallCount) {
+        hints.cellChanged(row, col);
+        timeline.add({ row, col, float(row - fallCount), float(col), float(row), float(col), start, FALL_DURATION, Easing::EASE_IN_QUAD });
+    });
 }
 
 void Game::endTurn() {
     // Check game over conditions only after all animations and cascades are complete
-    if (!m_isAnimating && !m_isCascading && !m_isDropping && !m_isRefilling) {
+    if (phase == Phase::IDLE) {
         if (currentStatus == ONGOING) {
             movesLeft--;
         }
@@ -203,7 +241,7 @@ void Game::endTurn() {
             currentStatus = WIN;
         }
         else if (movesLeft <= 0) { // Check moves left explicitly
-            if (!hasValidMoves()) {
+            if (!Rules::hasValidMoves(board)) {
                 currentStatus = LOSE; // Set status to LOSE if out of moves and no valid moves left
             }
             else {
@@ -211,7 +249,7 @@ void Game::endTurn() {
                 currentStatus = LOSE; // This seems contradictory to the comment, setting to LOSE as per original code
             }
         }
-        else if (!hasValidMoves()) { // Check for valid moves remaining
+        else if (!Rules::hasValidMoves(board)) { // Check for valid moves remaining
             currentStatus = LOSE; // Lose if no valid moves left (regardless of movesLeft count)
         }
         else {
@@ -227,121 +265,74 @@ void Game::endTurn() {
 
 
 bool Game::isValidSwap(int r1, int c1, int r2, int c2) const {
-    // Check boundary conditions first
-    if (r1 < 0 || r1 >= GRID_SIZE || c1 < 0 || c1 >= GRID_SIZE ||
-        r2 < 0 || r2 >= GRID_SIZE || c2 < 0 || c2 >= GRID_SIZE) {
-        return false;
-    }
-
-    // Check if the swap is between adjacent gems
-    int dr = std::abs(r1 - r2);
-    int dc = std::abs(c1 - c2);
-
-    return (dr + dc == 1);
-}
-
-bool Game::checkPotentialMatch(int r1, int c1, int r2, int c2) const {
-    // Create a temporary copy of the board
-    Game temp = *this;
-
-    // Perform the hypothetical swap on the temporary board
-    temp.swapGems(r1, c1, r2, c2);
-
-    // Check if the temporary board has any matches after the swap
-    return temp.hasMatches();
+    return Rules::inBounds(board, r1, c1) && Rules::inBounds(board, r2, c2) && Rules::isAdjacent(r1, c1, r2, c2);
 }
 
 void Game::swapGems(int r1, int c1, int r2, int c2) {
     std::swap(board[r1][c1], board[r2][c2]);
+    hints.cellChanged(r1, c1);
+    hints.cellChanged(r2, c2);
 }
 
-bool Game::hasMatches() const {
-    // Check for horizontal matches
-    for (int r = 0; r < GRID_SIZE; ++r) {
-        for (int c = 0; c < GRID_SIZE - 2; ++c) {
-            GemType type = board[r][c];
-            if (type != EMPTY &&
-                type == board[r][c + 1] &&
-                type == board[r][c + 2]) {
-                return true;
-            }
+// Plays one match sound per gem type cleared
+void Game::playMatchSounds(const MatchInfo& matchInfo) const {
+    for (int type = RED_GEM; type <= MAGENTA_GEM; ++type) {
+        if (matchInfo.gemTypeMatched[type]) {
+            PlayGemMatchSound(static_cast<Game::GemType>(type));
         }
     }
-
-    // Check for vertical matches
-    for (int c = 0; c < GRID_SIZE; ++c) {
-        for (int r = 0; r < GRID_SIZE - 2; ++r) {
-            GemType type = board[r][c];
-            if (type != EMPTY &&
-                type == board[r + 1][c] &&
-                type == board[r + 2][c]) {
-                return true;
-            }
-        }
-    }
-
-    return false;
 }
 
 // clearMatches function now returns MatchInfo
+// The shared rules scan the board once, merge runs that share a cell into L/T groups and pay
+// each group; the groups are copied out as they are reported and the points summed from them.
+// Everything lives on the stack.
 MatchInfo Game::clearMatches() {
-    std::vector<std::vector<bool>> matched(GRID_SIZE,
-        std::vector<bool>(GRID_SIZE, false));
+    static_assert(MAX_MATCH_GROUPS >= Match3::maxRuns(GRID_SIZE, GRID_SIZE), "Every group must fit in MatchInfo");
     MatchInfo info;
     info.totalCleared = 0;
-    std::vector<bool> gemTypeMatched(MAGENTA_GEM + 1, false);
-
-    // Mark horizontal matches
-    for (int r = 0; r < GRID_SIZE; ++r) {
-        for (int c = 0; c < GRID_SIZE - 2; ++c) {
-            GemType type = board[r][c];
-            if (type != EMPTY &&
-                type == board[r][c + 1] &&
-                type == board[r][c + 2]) {
-                matched[r][c] = matched[r][c + 1] = matched[r][c + 2] = true;
-                gemTypeMatched[type] = true;
-            }
-        }
-    }
-
-    // Mark vertical matches (also mark gems already marked by horizontal matches)
-    for (int c = 0; c < GRID_SIZE; ++c) {
-        for (int r = 0; r < GRID_SIZE - 2; ++r) {
-            GemType type = board[r][c];
-            if (type != EMPTY &&
-                type == board[r + 1][c] &&
-                type == board[r + 2][c]) {
-                matched[r][c] = matched[r + 1][c] = matched[r + 2][c] = true;
-                gemTypeMatched[type] = true;
-            }
+    info.points = 0;
+    info.groupCount = 0;
+    for (bool& matched : info.gemTypeMatched) matched = false;
+
+    auto onClear = [this](int row, int col, int gem) {
+        hints.cellChanged(row, col);
+        emitMatchParticles(row, col, static_cast<GemType>(gem));
+    };
+    auto onGroup = [&info](const Match3::Group& found) {
+        MatchGroup& group = info.groups[info.groupCount++];
+        group.gemType = found.gem;
+        group.cellCount = found.cells;
+        group.longestRun = found.longestRun;
+        group.row = found.row;
+        group.col = found.col;
+        group.points = found.points;
+        if (found.runs > 1) {
+            group.shape = found.crossesMiddle ? MatchShape::T_SHAPE : MatchShape::L_SHAPE;
         }
-    }
-
-    // Clear marked gems and count them
-    for (int r = 0; r < GRID_SIZE; ++r) {
-        for (int c = 0; c < GRID_SIZE; ++c) {
-            if (matched[r][c]) {
-                board[r][c] = EMPTY;
-                info.totalCleared++;
-            }
-        }
-    }
-
-    // Add matched gem types to the result
-    for (int i = RED_GEM; i <= MAGENTA_GEM; i++) {
-        if (gemTypeMatched[i]) {
-            info.gemTypesMatched.push_back(static_cast<GemType>(i));
+        else {
+            group.shape = found.cells >= 5 ? MatchShape::LINE_5 : (found.cells == 4 ? MatchShape::LINE_4 : MatchShape::LINE_3);
         }
-    }
-
+        info.gemTypeMatched[group.gemType] = true;
+        info.points += group.points;
+    };
+    info.totalCleared = Rules::clearMatches(board, 1, cascadeDepth, onClear, onGroup).gems;
     return info;
 }
 
 
-void Game::addScore(int matches) {
-    // Basic scoring: 100 points per cleared gem
-    int points = matches * 100;
+// Bursts particles in the gem's color from the center of a cleared cell
+void Game::emitMatchParticles(int row, int col, GemType type) {
+    const int cellStep = GEM_SIZE + GEM_SPACING;
+    int boardSize = GRID_SIZE * cellStep;
+    int boardX = (WINDOW_WIDTH - boardSize) / 2;
+    int boardY = 120 + (WINDOW_HEIGHT - 120 - boardSize) / 2; // Same layout as draw()
+    float x = boardX + col * cellStep + GEM_SIZE * 0.5f;
+    float y = boardY + row * cellStep + GEM_SIZE * 0.5f;
+    particles.emit(x, y, getGemColor(type), PARTICLES_PER_GEM);
+}
 
+void Game::addScore(int points) {
     if (currentPlayer == PLAYER_1) {
         player1Score += points;
     }
@@ -350,87 +341,6 @@ void Game::addScore(int matches) {
     }
 }
 
-void Game::dropGems() {
-    droppedGems.clear();
-    gemDropStartRow.assign(GRID_SIZE, std::vector<int>(GRID_SIZE, -1)); // Reset drop start rows
-
-    bool anyGemsDropped = false;
-
-    // For each column, move non-empty gems down to fill empty spaces
-    for (int c = 0; c < GRID_SIZE; ++c) {
-        int writeRow = GRID_SIZE - 1; // Start from the bottom
-        for (int r = GRID_SIZE - 1; r >= 0; --r) {
-            if (board[r][c] != EMPTY) {
-                if (writeRow != r) {
-                    // Record the original position for animation
-                    gemDropStartRow[writeRow][c] = r;
-
-                    // Move gem down
-                    board[writeRow][c] = board[r][c];
-                    board[r][c] = EMPTY;
-
-                    // Add to dropped gems list for animation
-                    // droppedGems.push_back({writeRow, c}); // Store destination
-
-                    anyGemsDropped = true; // Mark that a gem was moved
-                }
-                writeRow--; // Move the write position up
-            }
-        }
-    }
-
-    // Populate droppedGems based on gemDropStartRow for animation
-    for (int r = 0; r < GRID_SIZE; ++r) {
-        for (int c = 0; c < GRID_SIZE; ++c) {
-            if (gemDropStartRow[r][c] != -1) {
-                droppedGems.push_back({ r, c }); // Store the destination (current) position
-            }
-        }
-    }
-
-
-    // If any gems were moved, start the dropping animation
-    if (anyGemsDropped) {
-        m_isDropping = true;
-        dropAnimationProgress = 0.0f;
-    }
-    else {
-        // If no gems dropped, immediately move to refilling (though refill is instant)
-        m_isDropping = false;
-        m_isRefilling = true; // This will cause refillBoard to be called in the next update
-    }
-}
-
-void Game::refillBoard() {
-    // Fill in the empty spaces from the top
-    for (int c = 0; c < GRID_SIZE; ++c) {
-        for (int r = 0; r < GRID_SIZE; ++r) {
-            if (board[r][c] == EMPTY) {
-                board[r][c] = static_cast<GemType>(1 + std::rand() % 5); // Assign random gem type (1-5)
-            }
-        }
-    }
-    // No need to clear droppedGems or gemDropStartRow here, done after drop animation
-}
-
-bool Game::hasValidMoves() const {
-    // Check for potential matches after any possible swap
-    for (int r = 0; r < GRID_SIZE; ++r) {
-        for (int c = 0; c < GRID_SIZE; ++c) {
-            // Check swap with gem below
-            if ((r + 1 < GRID_SIZE && checkPotentialMatch(r, c, r + 1, c))) {
-                return true;
-            }
-            // Check swap with gem to the right
-            if (c + 1 < GRID_SIZE && checkPotentialMatch(r, c, r, c + 1)) {
-                return true;
-            }
-        }
-    }
-    return false; // No valid moves found
-}
-
-
 SDL_Color Game::getGemColor(GemType type) const {
     switch (type) {
     case RED_GEM: return { 255, 0, 0, 255 };
@@ -465,93 +375,72 @@ void Game::drawGem(SDL_Renderer* renderer, GemType type, int x, int y,
 }
 
 void Game::draw(SDL_Renderer* renderer, SDL_Texture* blueTex, SDL_Texture* greenTex,
-    SDL_Texture* magentaTex, SDL_Texture* redTex, SDL_Texture* yellowTex) {
-    int boardHeight = GRID_SIZE * (GEM_SIZE + GEM_SPACING);
-    int boardWidth = GRID_SIZE * (GEM_SIZE + GEM_SPACING);
+    SDL_Texture* magentaTex, SDL_Texture* redTex, SDL_Texture* yellowTex, bool withHint) {
+    const int cellStep = GEM_SIZE + GEM_SPACING;
+    int boardHeight = GRID_SIZE * cellStep;
+    int boardWidth = GRID_SIZE * cellStep;
     int boardX = (WINDOW_WIDTH - boardWidth) / 2;
     int boardY = 120 + (WINDOW_HEIGHT - 120 - boardHeight) / 2; // Uses UL_HEADER_HEIGHT implicitly from main.cpp logic
 
+    // Cells whose gem is in flight are drawn by the tween pass instead
+    bool moving[GRID_SIZE][GRID_SIZE] = {};
+    for (int i = 0; i < timeline.size(); ++i) {
+        moving[timeline.at(i).row][timeline.at(i).col] = true;
+    }
+
+    // Draw stationary gems
     for (int r = 0; r < GRID_SIZE; ++r) {
         for (int c = 0; c < GRID_SIZE; ++c) {
-            int x = boardX + c * (GEM_SIZE + GEM_SPACING);
-            int y = boardY + r * (GEM_SIZE + GEM_SPACING);
-
-            GemType gemToDraw = board[r][c]; // Default to drawing the gem currently in the board data
-
-            // Animate swap
-            if (m_isAnimating && ((r == swapR1 && c == swapC1) || (r == swapR2 && c == swapC2))) {
-                // Calculate the displacement based on animation progress
-                float progress = swapAnimationProgress;
-
-                int fromR = (r == swapR1 && c == swapC1) ? swapR1 : swapR2;
-                int fromC = (r == swapR1 && c == swapC1) ? swapC1 : swapC2;
-                int toR = (r == swapR1 && c == swapC1) ? swapR2 : swapR1;
-                int toC = (r == swapR1 && c == swapC1) ? swapC2 : swapC1;
-
-                // Calculate the starting pixel position of the gem before the swap
-                int startX = boardX + fromC * (GEM_SIZE + GEM_SPACING);
-                int startY = boardY + fromR * (GEM_SIZE + GEM_SPACING);
+            if (!moving[r][c] && board[r][c] != EMPTY) {
+                drawGem(renderer, board[r][c], boardX + c * cellStep, boardY + r * cellStep, blueTex, greenTex, magentaTex, redTex, yellowTex);
+            }
+        }
+    }
 
-                // Calculate the ending pixel position of the gem after the swap
-                int endX = boardX + toC * (GEM_SIZE + GEM_SPACING);
-                int endY = boardY + toR * (GEM_SIZE + GEM_SPACING);
+    // Draw only the gems that are moving, clipped so new gems slide in from the top edge of the board
+    if (!timeline.isIdle()) {
+        SDL_Rect boardRect = { boardX, boardY, boardWidth, boardHeight };
+        SDL_RenderSetClipRect(renderer, &boardRect);
+        for (int i = 0; i < timeline.size(); ++i) {
+            const Tween& tween = timeline.at(i);
+            float row, col;
+            timeline.sample(tween, row, col);
+            drawGem(renderer, board[tween.row][tween.col], boardX + static_cast<int>(col * cellStep),
+                boardY + static_cast<int>(row * cellStep), blueTex, greenTex, magentaTex, redTex, yellowTex);
+        }
+        SDL_RenderSetClipRect(renderer, nullptr);
+    }
 
-                // Calculate the current interpolated position
-                int currentX = startX + static_cast<int>((endX - startX) * progress);
-                int currentY = startY + static_cast<int>((endY - startY) * progress);
+    particles.draw(renderer);
+    if (withHint) {
+        drawHint(renderer, boardX, boardY, cellStep);
+    }
 
-                // Draw the gem at its interpolated position during the swap
-                // To draw the correct gem type during the swap, we need the gem type *before* the swap.
-                // Since the board state is updated *after* animation progress >= 1.0,
-                // board[r][c] should still hold the gem type from *before* the swap for this frame.
-                drawGem(renderer, gemToDraw, currentX, currentY, blueTex, greenTex, magentaTex, redTex, yellowTex);
+    // Draw selected outline
+    if (selectedRow >= 0 && selectedCol >= 0 && phase == Phase::IDLE && board[selectedRow][selectedCol] != EMPTY) {
+        SDL_Rect outline = { boardX + selectedCol * cellStep - 2, boardY + selectedRow * cellStep - 2, GEM_SIZE + 4, GEM_SIZE + 4 };
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderDrawRect(renderer, &outline);
+    }
+}
 
-            }
-            // Animate dropping
-            else if (m_isDropping) {
-                bool isThisGemDropping = false;
-                int startDropRow = -1;
-
-                // Check if the gem that *ends up* at (r, c) after dropping started from a higher row
-                if (gemDropStartRow[r][c] != -1) {
-                    isThisGemDropping = true;
-                    startDropRow = gemDropStartRow[r][c];
-                }
-
-                if (isThisGemDropping && startDropRow != -1) {
-                    // The gem at board[r][c] is the one that dropped to this position.
-                    // It started from startDropRow, column c.
-                    int startY = boardY + startDropRow * (GEM_SIZE + GEM_SPACING);
-                    int endY = y; // The destination is the current row's y coordinate
-
-                    int currentY = startY + static_cast<int>((endY - startY) * dropAnimationProgress);
-
-                    // Draw the gem at its interpolated position during the drop
-                    drawGem(renderer, gemToDraw, x, currentY, blueTex, greenTex, magentaTex, redTex, yellowTex);
-
-                }
-                else {
-                    // If a gem is not involved in the current drop animation, draw it stationary
-                    if (gemToDraw != EMPTY) {
-                        drawGem(renderer, gemToDraw, x, y, blueTex, greenTex, magentaTex, redTex, yellowTex);
-                    }
-                }
-            }
-            // Draw stationary gems
-            else {
-                // Only draw if the gem is not EMPTY and not currently involved in swap/drop animation
-                if (gemToDraw != EMPTY) {
-                    drawGem(renderer, gemToDraw, x, y, blueTex, greenTex, magentaTex, redTex, yellowTex);
-                }
-            }
+// Pulses an outline around both gems of the best swap while the board waits for a move
+void Game::drawHint(SDL_Renderer* renderer, int boardX, int boardY, int cellStep) {
+    Match3::SwapIndex<Match3::GridBoard<GemType>>::Swap swap;
+    if (!showHint || phase != Phase::IDLE || currentStatus != ONGOING || !hints.best(board, swap)) {
+        return;
+    }
 
-            // Draw selected outline - MOVED INSIDE THE LOOPS
-            if (r == selectedRow && c == selectedCol && !m_isAnimating && !m_isDropping
-                && !m_isCascading && !m_isRefilling && board[r][c] != EMPTY) { // Added checks for all animation states and non-empty
-                SDL_Rect outline = { x - 2, y - 2, GEM_SIZE + 4, GEM_SIZE + 4 };
-                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-                SDL_RenderDrawRect(renderer, &outline);
-            }
+    Uint8 alpha = static_cast<Uint8>(128 + 127 * std::sin(hintTime * 6.0f));
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 255, 215, 0, alpha);
+    int rows[2] = { swap.row1, swap.row2 };
+    int cols[2] = { swap.col1, swap.col2 };
+    for (int i = 0; i < 2; ++i) {
+        for (int inset = 0; inset < 2; ++inset) { // 2px thick
+            SDL_Rect outline = { boardX + cols[i] * cellStep - 3 + inset, boardY + rows[i] * cellStep - 3 + inset,
+                GEM_SIZE + 6 - 2 * inset, GEM_SIZE + 6 - 2 * inset };
+            SDL_RenderDrawRect(renderer, &outline);
         }
     }
 }
@@ -2,13 +2,41 @@
 
 #include <vector>
 #include <SDL2/SDL.h>
+#include "timeline.h"
+#include "particles.h"
+#include "../common/match3_scoring.h"
+#include "../common/match3_hints.h"
+
+// Shape of a group of matched gems, used for scoring and special gems
+enum class MatchShape { LINE_3, LINE_4, LINE_5, L_SHAPE, T_SHAPE };
+
+// One connected group of matched gems of the same type.
+// Runs that cross or touch at a shared cell are merged into one L or T group.
+struct MatchGroup {
+    int gemType; // Use int or the underlying type of GemType
+    MatchShape shape;
+    int cellCount; // Distinct gems in the group
+    int longestRun; // Longest straight run in the group (5 or more is a LINE_5 even inside an L or T)
+    int row; // Where the runs cross for L/T, otherwise the middle of the run
+    int col;
+    int points; // What the group paid, once for all of its gems
+};
+
+// An 8x8 board holds at most two runs per row and per column, so at most this many groups
+const int MAX_MATCH_GROUPS = 32;
 
 // Define the MatchInfo struct here so it's visible to both Game.cpp and main.cpp
+// Fixed-size so clearing matches never allocates
 struct MatchInfo {
     int totalCleared;
-    std::vector<int> gemTypesMatched; // Use int or the underlying type of GemType
+    int points; // What the cleared gems are worth: the sum of the groups' points
+    bool gemTypeMatched[6]; // Indexed by GemType
+    int groupCount;
+    MatchGroup groups[MAX_MATCH_GROUPS];
 };
 
+struct GameSnapshot; // snapshot.h
+
 // Removed the extern declaration for PlayGemMatchSound from here.
 // It will be declared in main.cpp after including Game.h,
 // and forward-declared in Game.cpp.
@@ -25,6 +53,10 @@ public:
     static const int GEM_SPACING = 2;
     static const int MAX_MOVES = 30;
     static const int WIN_SCORE = 10000;
+    static const int POINTS_PER_GEM = 100; // Before any score file
+
+    // Flat scoring that a score file can retune while the game runs (see match3_scoring.h)
+    typedef Match3::TunableScoring<Match3::FlatScoring<POINTS_PER_GEM>> Scoring;
     static const int WINDOW_WIDTH = 800;
     static const int WINDOW_HEIGHT = 700;
 
@@ -32,50 +64,68 @@ public:
 
     void reset();
 
-    const std::vector<std::vector<GemType>>& getBoard() const { return board; }
+    const Match3::GridBoard<GemType>& getBoard() const { return board; }
     GameStatus status() const { return currentStatus; }
     int getPlayerScore(Player player) const { return player == PLAYER_1 ? player1Score : player2Score; }
     Player getCurrentPlayer() const { return currentPlayer; }
     int getMovesLeft() const { return movesLeft; }
     int getSelectedRow() const { return selectedRow; }
     int getSelectedCol() const { return selectedCol; }
-    bool isAnimating() const { return m_isAnimating; }
-    bool isCascading() const { return m_isCascading; }
-    bool isDropping() const { return m_isDropping; }
-    bool isRefilling() const { return m_isRefilling; } // Added isRefilling getter
+    bool isSwapping() const { return phase == Phase::SWAPPING; }
+    bool isCascading() const { return phase == Phase::FALLING; }
+    bool isBusy() const { return phase != Phase::IDLE; } // True until a swap and all its cascades have settled
+    bool isAnimating() const { return isBusy() || !timeline.isIdle() || particles.size() > 0; } // Whether draw() would change from frame to frame
+
+    // While on, draw() outlines the swap that clears the most gems whenever the board is settled
+    void toggleHint() { showHint = !showHint; }
+    bool isHintShown() const { return showHint; }
 
     void setSelectedGem(int row, int col);
     void endTurn();
     void update(float deltaTime);
     void play(int r1, int c1, int r2, int c2);
 
-    // draw function now takes textures
+    // Copies the whole match, including an animation in flight, into a fixed-layout snapshot.
+    // Restoring returns false and leaves the game untouched if the snapshot does not hold a
+    // valid match. Particles are not part of a snapshot.
+    void saveSnapshot(GameSnapshot& snapshot) const;
+    bool restoreSnapshot(const GameSnapshot& snapshot);
+
+    // draw function now takes textures; withHint is false when the board sits behind an overlay
     void draw(SDL_Renderer* renderer, SDL_Texture* blueTex, SDL_Texture* greenTex,
-        SDL_Texture* magentaTex, SDL_Texture* redTex, SDL_Texture* yellowTex);
+        SDL_Texture* magentaTex, SDL_Texture* redTex, SDL_Texture* yellowTex, bool withHint = true);
 
     // Modifications to Game.h - Add new function declaration
     GemType getGemTypeAtPosition(int row, int col) const { return board[row][col]; }
 
 
 private:
-    std::vector<std::vector<GemType>> board;
+    typedef Match3::Rules<Match3::GridBoard<GemType>, Scoring> Rules; // Match, drop and refill
+
+    Match3::GridBoard<GemType> board;
     GameStatus currentStatus;
 
     int selectedRow;
     int selectedCol;
 
-    float swapAnimationProgress;
-    bool m_isAnimating;
+    // What the turn is waiting on; the timeline holds the gems that are actually moving
+    enum class Phase { IDLE, SWAPPING, FALLING };
+    Phase phase;
+    Timeline timeline;
+
+    static constexpr float SWAP_DURATION = 0.25f;
+    static constexpr float FALL_DURATION = 0.25f;
 
-    bool m_isCascading;
-    bool m_isDropping;
-    bool m_isRefilling; // State for after dropping, before checking new matches
+    int swapR1, swapC1, swapR2, swapC2; // Swap in progress, undone if it forms no match
+    int cascadeDepth; // Matches cleared so far this turn: 0 for the swap's own, then one per cascade
 
-    float dropAnimationProgress;
-    std::vector<std::pair<int, int>> droppedGems;
-    std::vector<std::vector<int>> gemDropStartRow; // Stores the row a gem started from before dropping
+    // Every swap's clear count, updated from the cells each step of a turn changes
+    Match3::SwapIndex<Match3::GridBoard<GemType>> hints;
+    bool showHint;
+    float hintTime; // Drives the outline's pulse
 
-    int swapR1, swapC1, swapR2, swapC2; // Store coordinates for animation...
+    static const int PARTICLES_PER_GEM = 24;
+    ParticleSystem particles; // Bursts from cleared gems, drawn over the board
 
     Player currentPlayer;
     int player1Score;
@@ -85,19 +135,18 @@ private:
 
     void initializeBoard();
     void animateSwap(int r1, int c1, int r2, int c2);
-    bool isValidSwap(int r1, int c1, int r2, int c2) const; // Corrected function signature
-    bool checkPotentialMatch(int r1, int c1, int r2, int c2) const; // Corrected function signature
+    void startFall();
+    bool isValidSwap(int r1, int c1, int r2, int c2) const; // In bounds and adjacent, match or not
     void swapGems(int r1, int c1, int r2, int c2); // Corrected function signature
-    bool hasMatches() const;
 
     // clearMatches function now returns MatchInfo
     MatchInfo clearMatches();
+    void playMatchSounds(const MatchInfo& matchInfo) const;
+    void emitMatchParticles(int row, int col, GemType type);
+    void drawHint(SDL_Renderer* renderer, int boardX, int boardY, int cellStep);
 
 
-    void addScore(int matches);
-    void dropGems();
-    void refillBoard();
-    bool hasValidMoves() const;
+    void addScore(int points);
     SDL_Color getGemColor(GemType type) const;
     void drawGem(SDL_Renderer* renderer, GemType type, int x, int y, SDL_Texture* blueTex,
         SDL_Texture* greenTex, SDL_Texture* magentaTex, SDL_Texture* redTex,
@@ -0,0 +1,68 @@
+#include "layer_cache.h"
+#include <algorithm>
+#include <cmath>
+#include "logger.h"
+
+LayerCache::LayerCache(SDL_Renderer* renderer, int width, int height)
+    : renderer(renderer), target(nullptr), width(width), height(height), pixelWidth(width), pixelHeight(height),
+    cachedLayer(NO_LAYER) {
+    updateSize();
+    createTarget();
+}
+
+LayerCache::~LayerCache() {
+    destroy();
+}
+
+void LayerCache::destroy() {
+    if (target) SDL_DestroyTexture(target);
+    target = nullptr;
+}
+
+void LayerCache::handleEvent(const SDL_Event& event) {
+    if (event.type == SDL_WINDOWEVENT && (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+        event.window.event == SDL_WINDOWEVENT_DISPLAY_CHANGED)) {
+        int oldWidth = pixelWidth;
+        int oldHeight = pixelHeight;
+        updateSize();
+        if (pixelWidth != oldWidth || pixelHeight != oldHeight) {
+            destroy();
+            createTarget();
+        }
+    }
+    else if (event.type == SDL_RENDER_TARGETS_RESET) {
+        invalidate();
+    }
+    else if (event.type == SDL_RENDER_DEVICE_RESET) {
+        // Every texture was lost with the device, the target included
+        destroy();
+        createTarget();
+    }
+}
+
+void LayerCache::createTarget() {
+    target = nullptr;
+    cachedLayer = NO_LAYER;
+    if (!SDL_RenderTargetSupported(renderer)) {
+        LOG_WARN("Render targets unsupported, menus are drawn every frame");
+        return;
+    }
+    target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, pixelWidth, pixelHeight);
+    if (!target) {
+        LOG_WARN("Failed to create the menu layer: %s", SDL_GetError());
+    }
+    else {
+        SDL_SetTextureBlendMode(target, SDL_BLENDMODE_NONE); // Opaque, so the copy to the window is a plain blit
+    }
+}
+
+// Letterboxed like SDL_RenderSetLogicalSize and TextureCache: the smaller of the two axis scales
+void LayerCache::updateSize() {
+    int outputWidth = width;
+    int outputHeight = height;
+    SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight);
+    float scale = std::min(static_cast<float>(outputWidth) / width, static_cast<float>(outputHeight) / height);
+    if (scale <= 0.0f) return;
+    pixelWidth = std::max(1, static_cast<int>(std::lround(width * scale)));
+    pixelHeight = std::max(1, static_cast<int>(std::lround(height * scale)));
+}
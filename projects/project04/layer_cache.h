@@ -0,0 +1,64 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// A full-window render target holding one screen that does not change from frame to frame.
+// The first frame of a screen renders it into the target; every frame after that is a single
+// copy to the window, until the caller invalidates the layer on a state change. Renderers
+// without render targets draw the screen directly every frame instead. The target has as many
+// pixels as the window shows the screen with, so the copy is never stretched, and it is made
+// again whenever the window's size or display changes.
+class LayerCache {
+public:
+    // width x height is the screen's size in logical pixels, as given to SDL_RenderSetLogicalSize
+    LayerCache(SDL_Renderer* renderer, int width, int height);
+    ~LayerCache();
+
+    LayerCache(const LayerCache&) = delete;
+    LayerCache& operator=(const LayerCache&) = delete;
+
+    // Draws layer to the window, rendering it with drawLayer() first if the target holds
+    // something else or has been invalidated
+    template <typename DrawLayer>
+    void draw(int layer, DrawLayer drawLayer) {
+        if (!target) {
+            drawLayer();
+            return;
+        }
+        if (layer != cachedLayer) {
+            SDL_SetRenderTarget(renderer, target);
+            // A target is drawn in its own pixels; the window's scale comes back with the window
+            SDL_RenderSetScale(renderer, static_cast<float>(pixelWidth) / width, static_cast<float>(pixelHeight) / height);
+            SDL_SetRenderDrawColor(renderer, 40, 40, 40, 255); // Same clear color as the window
+            SDL_RenderClear(renderer);
+            drawLayer();
+            SDL_SetRenderTarget(renderer, nullptr);
+            cachedLayer = layer;
+        }
+        SDL_RenderCopy(renderer, target, nullptr, nullptr);
+    }
+
+    // Forces the next draw() to render its layer again
+    void invalidate() { cachedLayer = NO_LAYER; }
+
+    // Frees the target; call before destroying the renderer, which would otherwise free it first
+    void destroy();
+
+    // Call on window and render events: a resize or a move to another display remakes the
+    // target at the new pixel size, and a reset redraws what was lost
+    void handleEvent(const SDL_Event& event);
+
+private:
+    static const int NO_LAYER = -1;
+
+    SDL_Renderer* renderer;
+    SDL_Texture* target; // Null if the renderer cannot render to textures
+    int width;
+    int height;
+    int pixelWidth; // Size of the target, the screen's size on the window
+    int pixelHeight;
+    int cachedLayer;
+
+    void createTarget();
+    void updateSize();
+};
@@ -0,0 +1,124 @@
+// logger.cpp
+
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    const char* levelName(LogLevel level) {
+        switch (level) {
+        case LogLevel::DEBUG_LEVEL: return "[DEBUG] ";
+        case LogLevel::INFO_LEVEL: return "[INFO] ";
+        case LogLevel::WARN_LEVEL: return "[WARN] ";
+        default: return "[ERROR] ";
+        }
+    }
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : enqueuePos(0), dequeuePos(0), droppedCount(0), running(true) {
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    drainThread = std::thread(&Logger::drainLoop, this);
+}
+
+Logger::~Logger() {
+    shutdown();
+}
+
+void Logger::log(LogLevel level, const char* format, ...) {
+    // Claim a slot (bounded multi-producer queue: a slot is free when its sequence equals the position)
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & (CAPACITY - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed); // Ring is full
+            return;
+        }
+        else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(slot->text, MESSAGE_SIZE, format, args);
+    va_end(args);
+    slot->sequence.store(pos + 1, std::memory_order_release); // Hand the slot to the drain thread
+}
+
+bool Logger::drainOnce() {
+    char out[16 * 1024];
+    size_t length = 0;
+    bool drainedAny = false;
+
+    while (true) {
+        Slot& slot = slots[dequeuePos & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) break; // Nothing published yet
+
+        const char* prefix = levelName(slot.level);
+        size_t prefixLength = std::strlen(prefix);
+        size_t textLength = std::strlen(slot.text);
+        if (length + prefixLength + textLength + 1 > sizeof(out)) {
+            std::fwrite(out, 1, length, stderr);
+            length = 0;
+        }
+        std::memcpy(out + length, prefix, prefixLength);
+        length += prefixLength;
+        std::memcpy(out + length, slot.text, textLength);
+        length += textLength;
+        out[length++] = '\n';
+
+        slot.sequence.store(dequeuePos + CAPACITY, std::memory_order_release); // Free the slot for producers
+        dequeuePos++;
+        drainedAny = true;
+    }
+
+    size_t dropped = droppedCount.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        char warning[64];
+        int written = std::snprintf(warning, sizeof(warning), "[WARN] logger dropped %zu messages\n", dropped);
+        size_t warningLength = written < 0 ? 0 : std::min(static_cast<size_t>(written), sizeof(warning) - 1);
+        if (length + warningLength > sizeof(out)) {
+            std::fwrite(out, 1, length, stderr);
+            length = 0;
+        }
+        std::memcpy(out + length, warning, warningLength);
+        length += warningLength;
+    }
+    if (length > 0) {
+        std::fwrite(out, 1, length, stderr);
+        std::fflush(stderr);
+    }
+    return drainedAny;
+}
+
+void Logger::drainLoop() {
+    while (running.load(std::memory_order_acquire)) {
+        if (!drainOnce()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    drainOnce(); // Whatever was queued before shutdown
+}
+
+void Logger::shutdown() {
+    if (running.exchange(false)) {
+        drainThread.join();
+    }
+}
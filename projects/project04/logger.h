@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+enum class LogLevel { DEBUG_LEVEL = 0, INFO_LEVEL = 1, WARN_LEVEL = 2, ERROR_LEVEL = 3 };
+
+// Lowest level compiled into the program. Calls below it expand to nothing, so their
+// arguments are never evaluated. Debug builds keep everything, release builds drop DEBUG.
+#ifndef LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define LOG_MIN_LEVEL 0
+#else
+#define LOG_MIN_LEVEL 1
+#endif
+#endif
+
+#if LOG_MIN_LEVEL <= 0
+#define LOG_DEBUG(...) Logger::instance().log(LogLevel::DEBUG_LEVEL, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+#if LOG_MIN_LEVEL <= 1
+#define LOG_INFO(...) Logger::instance().log(LogLevel::INFO_LEVEL, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+#if LOG_MIN_LEVEL <= 2
+#define LOG_WARN(...) Logger::instance().log(LogLevel::WARN_LEVEL, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+#define LOG_ERROR(...) Logger::instance().log(LogLevel::ERROR_LEVEL, __VA_ARGS__)
+
+// Asynchronous logger for the game loop.
+// log() formats a printf-style message straight into a slot of a fixed, lock-free ring
+// buffer and returns; a background thread drains the ring and does the console I/O.
+// If the ring is full the message is dropped and counted instead of blocking the caller.
+class Logger {
+public:
+    static const int CAPACITY = 1024; // Slots, must be a power of two
+    static const int MESSAGE_SIZE = 256; // Longer messages are truncated
+
+    static Logger& instance();
+
+    // Safe to call from any thread
+#if defined(__GNUC__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    void log(LogLevel level, const char* format, ...);
+
+    // Writes out everything queued so far and stops the background thread
+    void shutdown();
+
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence; // Tells producers and the consumer whose turn the slot is
+        LogLevel level;
+        char text[MESSAGE_SIZE];
+    };
+
+    Slot slots[CAPACITY];
+    std::atomic<size_t> enqueuePos;
+    size_t dequeuePos; // Only touched by the drain thread
+    std::atomic<size_t> droppedCount;
+    std::atomic<bool> running;
+    std::thread drainThread;
+
+    Logger();
+    void drainLoop();
+    bool drainOnce(); // Returns false if the ring was empty
+};
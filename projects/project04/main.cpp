@@ -6,9 +6,27 @@
 #include <SDL_ttf.h>
 #include <SDL_image.h>
 #include <SDL_mixer.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <cstring>
+#include <vector>
 #include "Game.h" // Include Game.h first
+#include "logger.h"
+#include "server.h"
+#include "spectator.h"
+#include "tournament.h"
+#include "snapshot.h"
+#include "vec_env.h"
+#include "layer_cache.h"
+#include "texture_cache.h"
+#include "../common/match3_bench.h"
+#include "../common/move_reader.h"
 #include <SDL2_gfxPrimitives.h>
 
 // Declare the PlayGemMatchSound function here, after Game.h is included
@@ -16,6 +34,8 @@ extern void PlayGemMatchSound(Game::GemType gemType);
 
 
 const int UL_HEADER_HEIGHT = 120;
+const char* const SNAPSHOT_PATH = "project04.snapshot"; // Autosave of the match in progress
+const char* const SCORES_PATH = "scores.cfg"; // Optional score file, reloaded between turns when it changes
 
 enum GameState {
     START_SCREEN,
@@ -24,13 +44,57 @@ enum GameState {
     EXIT_MENU
 };
 
-// Helper function to load a texture
-SDL_Texture* LoadTexture(SDL_Renderer* renderer, const std::string& filePath) {
-    SDL_Texture* texture = IMG_LoadTexture(renderer, filePath.c_str());
-    if (!texture) {
-        std::cerr << "Error loading texture '" << filePath << "': " << IMG_GetError() << std::endl;
-    }
-    return texture;
+// Ids of the game's images in its TextureCache
+struct GameImages {
+    int blue, green, magenta, red, yellow;
+    int background, startBackground, exitBackground, winBackground;
+    int startButton, restartButton, exitButton;
+    int player1Win, player2Win;
+};
+
+// Loads every image the screens draw. Returns false if any is missing.
+static bool loadGameImages(TextureCache& textures, GameImages& images) {
+    bool loaded = true;
+    auto load = [&](const char* path) {
+        int id = textures.load(path);
+        loaded = loaded && id >= 0;
+        return id;
+    };
+    images.blue = load("assets/blue.png");
+    images.green = load("assets/green.png");
+    images.magenta = load("assets/magenta.png");
+    images.red = load("assets/red.png");
+    images.yellow = load("assets/yellow.png");
+    images.background = load("assets/background.png");
+    images.startBackground = load("assets/startbackground.png");
+    images.exitBackground = load("assets/exitbackground.png");
+    images.winBackground = load("assets/winbackground.png");
+    images.startButton = load("assets/startbutton.png");
+    images.restartButton = load("assets/restartbutton.png");
+    images.exitButton = load("assets/exitbutton.png");
+    images.player1Win = load("assets/player1win.png");
+    images.player2Win = load("assets/player2win.png");
+    return loaded;
+}
+
+// The board, with each gem texture sized to a cell. Without the hint when drawn behind an
+// overlay, whose cached layer would otherwise freeze the pulse mid-fade.
+static void drawBoard(SDL_Renderer* renderer, Game& game, TextureCache& textures, const GameImages& images,
+    bool withHint = true) {
+    const int size = Game::GEM_SIZE;
+    game.draw(renderer, textures.get(images.blue, size, size), textures.get(images.green, size, size),
+        textures.get(images.magenta, size, size), textures.get(images.red, size, size),
+        textures.get(images.yellow, size, size), withHint);
+}
+
+// Copies an image stretched over the whole window
+static void drawFullWindow(SDL_Renderer* renderer, TextureCache& textures, int image) {
+    SDL_RenderCopy(renderer, textures.get(image, Game::WINDOW_WIDTH, Game::WINDOW_HEIGHT), nullptr, nullptr);
+}
+
+// Copies an image into rect, from a texture pre-scaled to rect's size
+static void drawImage(SDL_Renderer* renderer, TextureCache& textures, int image, const SDL_Rect& rect) {
+    SDL_RenderCopy(renderer, textures.get(image, rect.w, rect.h), nullptr, &rect);
 }
 
 void renderText(SDL_Renderer* renderer, TTF_Font* font,
@@ -59,7 +123,7 @@ void PlaySoundEffect(Mix_Chunk* sound) {
         // Play on first available channel, no loops
         int channel = Mix_PlayChannel(-1, sound, 0);
         if (channel == -1) {
-            std::cerr << "Failed to play sound: " << Mix_GetError() << std::endl;
+            LOG_WARN("Failed to play sound: %s", Mix_GetError());
         }
         else {
             // Optional: Set volume for this specific play instance if needed
@@ -67,7 +131,7 @@ void PlaySoundEffect(Mix_Chunk* sound) {
         }
     }
     else {
-        std::cerr << "Attempted to play null sound effect" << std::endl;
+        LOG_WARN("Attempted to play null sound effect");
     }
 }
 
@@ -134,9 +198,309 @@ void PlayGemMatchSound(Game::GemType gemType) {
     }
 }
 
+// The HUD font from the first place it is found, or nullptr
+static TTF_Font* openFont() {
+    const char* fontPaths[] = {
+        "arial.ttf",
+        "fonts/arial.ttf",
+        "C:/Windows/Fonts/arial.ttf",
+        nullptr
+    };
+
+    TTF_Font* font = nullptr;
+    for (int i = 0; fontPaths[i] && !font; i++) {
+        font = TTF_OpenFont(fontPaths[i], 24);
+    }
+    return font;
+}
+
+// The match in progress: board, scores, target and moves left. Shared by the window and --headless
+static void drawMatchScreen(SDL_Renderer* renderer, TTF_Font* font, Game& game, TextureCache& textures,
+    const GameImages& images) {
+    drawFullWindow(renderer, textures, images.background);
+    drawBoard(renderer, game, textures, images);
+
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Color red = { 255, 150, 150, 255 };
+    SDL_Color blue = { 150, 150, 255, 255 };
+
+    // Draw scores and info
+    if (font) { // Only render text if font is loaded
+        SDL_Color p1Color = (game.getCurrentPlayer() == Game::PLAYER_1) ? red : white;
+        std::string p1Text = "Player 1: " + std::to_string(game.getPlayerScore(Game::PLAYER_1));
+        renderText(renderer, font, p1Text, 50, 20, p1Color); // Original was 20, changed to 50
+
+        SDL_Color p2Color = (game.getCurrentPlayer() == Game::PLAYER_2) ? blue : white;
+        std::string p2Text = "Player 2: " + std::to_string(game.getPlayerScore(Game::PLAYER_2));
+        int p2Width = 0;
+        TTF_SizeText(font, p2Text.c_str(), &p2Width, nullptr);
+        renderText(renderer, font, p2Text, Game::WINDOW_WIDTH - p2Width - 50, 20, p2Color);
+
+        std::string targetText = "Target: " + std::to_string(Game::WIN_SCORE);
+        int targetWidth = 0;
+        TTF_SizeText(font, targetText.c_str(), &targetWidth, nullptr);
+        renderText(renderer, font, targetText, (Game::WINDOW_WIDTH - targetWidth) / 2, 20, white);
+
+        std::string movesText = "Moves Left: " + std::to_string(game.getMovesLeft());
+        int movesWidth = 0;
+        TTF_SizeText(font, movesText.c_str(), &movesWidth, nullptr);
+        renderText(renderer, font, movesText, (Game::WINDOW_WIDTH - movesWidth) / 2, 50, white);
+    }
+}
+
+// "project04 --bench": times the shared rules on Game's board storage at several sizes and on
+// the fixed 8x8 byte boards VectorEnv steps
+static int runRulesBenchmark() {
+    typedef Match3::FlatScoring<VectorEnv::POINTS_PER_GEM> Scoring;
+    Match3::benchmarkGridSizes<Game::GemType, Game::Scoring>("project04 Game");
+
+    typedef Match3::FixedBoard<VectorEnv::GRID_SIZE, VectorEnv::GRID_SIZE> EnvBoard;
+    uint8_t cells[VectorEnv::CELLS];
+    EnvBoard board(cells);
+    Match3::printBenchResult("project04 VectorEnv", VectorEnv::GRID_SIZE, VectorEnv::GRID_SIZE,
+        Match3::benchmarkRules<EnvBoard, Scoring>(board, 100000));
+    return 0;
+}
+
+// FNV-1a over the visible pixels, so two runs can be compared frame by frame without images
+static uint64_t hashSurface(SDL_Surface* surface) {
+    uint64_t hash = 14695981039346656037ull;
+    SDL_LockSurface(surface);
+    for (int y = 0; y < surface->h; ++y) {
+        const Uint8* row = static_cast<const Uint8*>(surface->pixels) + y * surface->pitch;
+        for (int x = 0; x < surface->w * 4; ++x) {
+            hash = (hash ^ row[x]) * 1099511628211ull;
+        }
+    }
+    SDL_UnlockSurface(surface);
+    return hash;
+}
+
+// Reads a replay script in the move file format of the console batch modes (see
+// move_reader.h): "row1 col1 row2 col2" with 1-based coordinates, '#' to the end of a line is
+// a comment, so one script replays in every front-end. Moves are returned 0-based. Returns
+// false if the file cannot be read or holds something other than whole moves.
+static bool readReplayScript(const std::string& path, std::vector<std::array<int, 4>>& moves) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::fprintf(stderr, "Could not open replay script %s\n", path.c_str());
+        return false;
+    }
+    Match3::MoveReader reader(file);
+    int coords[4];
+    while (reader.nextMove(coords)) {
+        moves.push_back({ coords[0] - 1, coords[1] - 1, coords[2] - 1, coords[3] - 1 });
+    }
+    std::fclose(file);
+    if (reader.isMalformed()) {
+        std::fprintf(stderr, "%s: malformed move input on line %lld\n", path.c_str(), reader.getLine());
+        return false;
+    }
+    return true;
+}
+
+// First valid swap in row-major order, for replays that run past their script
+static bool firstValidMove(const Game& game, std::array<int, 4>& move) {
+    typedef Match3::Rules<Match3::GridBoard<Game::GemType>, Game::Scoring> Rules;
+    const Match3::GridBoard<Game::GemType>& board = game.getBoard();
+    for (int r = 0; r < Game::GRID_SIZE; ++r) {
+        for (int c = 0; c < Game::GRID_SIZE; ++c) {
+            if (Rules::isValidMove(board, r, c, r, c + 1)) {
+                move = { r, c, r, c + 1 };
+                return true;
+            }
+            if (Rules::isValidMove(board, r, c, r + 1, c)) {
+                move = { r, c, r + 1, c };
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// "project04 --headless [--script movefile] [--seed n] [--frames n] [--idle n] [--timings file.csv]
+// [--capture frame,frame,...] [--out dir]": plays a match through the same drawing code as the
+// window, rendered by SDL's software renderer into an offscreen surface, so it runs with no
+// display. The clock advances a fixed 1/60 s per frame and the gems come from --seed, so a
+// build always draws the same frames. Moves come from the script, then from the first valid
+// swap; each is played once the board has been settled for --idle frames. The run ends when
+// the match does and its last animation has finished, or after --frames frames.
+// Writes each frame's update and render time and pixel hash to --timings, and PNGs of the
+// --capture frames to --out.
+static int runHeadlessReplay(int argc, char* argv[]) {
+    std::string scriptPath;
+    std::string timingsPath;
+    std::string outDir = ".";
+    std::vector<int> captures;
+    unsigned int seed = 1;
+    int maxFrames = 100000;
+    int idleFrames = 10;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--script" && i + 1 < argc) {
+            scriptPath = argv[++i];
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--frames" && i + 1 < argc) {
+            maxFrames = std::atoi(argv[++i]);
+        }
+        else if (arg == "--idle" && i + 1 < argc) {
+            idleFrames = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (arg == "--timings" && i + 1 < argc) {
+            timingsPath = argv[++i];
+        }
+        else if (arg == "--capture" && i + 1 < argc) {
+            std::istringstream frames(argv[++i]);
+            std::string frame;
+            while (std::getline(frames, frame, ',')) {
+                captures.push_back(std::atoi(frame.c_str()));
+            }
+        }
+        else if (arg == "--out" && i + 1 < argc) {
+            outDir = argv[++i];
+        }
+        else {
+            std::fprintf(stderr, "Unknown option '%s'\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<std::array<int, 4>> script;
+    if (!scriptPath.empty() && !readReplayScript(scriptPath, script)) {
+        return 1;
+    }
+
+    // No video subsystem: the software renderer draws straight into a surface
+    SDL_Surface* frame = SDL_CreateRGBSurfaceWithFormat(0, Game::WINDOW_WIDTH, Game::WINDOW_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = frame ? SDL_CreateSoftwareRenderer(frame) : nullptr;
+    if (!renderer) {
+        std::fprintf(stderr, "Could not create the software renderer: %s\n", SDL_GetError());
+        if (frame) SDL_FreeSurface(frame);
+        return 1;
+    }
+    TTF_Init();
+    IMG_Init(IMG_INIT_PNG);
+
+    TextureCache textures(renderer, Game::WINDOW_WIDTH, Game::WINDOW_HEIGHT);
+    GameImages images;
+    bool texturesLoaded = loadGameImages(textures, images);
+    TTF_Font* font = openFont(); // The HUD is left out without it, as in the window
+
+    FILE* timings = nullptr;
+    if (texturesLoaded && !timingsPath.empty()) {
+        timings = std::fopen(timingsPath.c_str(), "w");
+        if (!timings) {
+            std::fprintf(stderr, "Could not write %s\n", timingsPath.c_str());
+        }
+        else {
+            std::fprintf(timings, "frame,update_us,render_us,hash\n");
+        }
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    auto microsecondsSince = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    };
+    const float FRAME_TIME = 1.0f / 60.0f;
+    std::vector<double> renderTimes;
+    size_t nextMove = 0;
+    int settledFrames = 0;
+    bool failed = !texturesLoaded || (!timingsPath.empty() && !timings);
+
+    Game game;
+    std::srand(seed); // Game seeds from the clock; gems must repeat from run to run
+    game.reset();
+    for (int frameNumber = 0; !failed && frameNumber < maxFrames; ++frameNumber) {
+        Clock::time_point start = Clock::now();
+        if (game.status() == Game::ONGOING && !game.isBusy() && ++settledFrames > idleFrames) {
+            std::array<int, 4> move;
+            if (nextMove < script.size()) {
+                move = script[nextMove++];
+            }
+            else if (!firstValidMove(game, move)) {
+                break;
+            }
+            game.play(move[0], move[1], move[2], move[3]);
+            if (!game.isBusy()) {
+                std::fprintf(stderr, "Skipped move %zu (%d,%d)-(%d,%d): no match\n", nextMove, move[0] + 1, move[1] + 1,
+                    move[2] + 1, move[3] + 1);
+            }
+            settledFrames = 0;
+        }
+        game.update(FRAME_TIME);
+        double updateTime = microsecondsSince(start);
+
+        start = Clock::now();
+        SDL_SetRenderDrawColor(renderer, 40, 40, 40, 255);
+        SDL_RenderClear(renderer);
+        drawMatchScreen(renderer, font, game, textures, images);
+        SDL_RenderFlush(renderer);
+        double renderTime = microsecondsSince(start);
+        renderTimes.push_back(renderTime);
+
+        if (timings) {
+            std::fprintf(timings, "%d,%.1f,%.1f,%016llx\n", frameNumber, updateTime, renderTime,
+                static_cast<unsigned long long>(hashSurface(frame)));
+        }
+        if (std::find(captures.begin(), captures.end(), frameNumber) != captures.end()) {
+            char path[64];
+            std::snprintf(path, sizeof(path), "/frame_%05d.png", frameNumber);
+            if (IMG_SavePNG(frame, (outDir + path).c_str()) != 0) {
+                std::fprintf(stderr, "Could not write %s%s: %s\n", outDir.c_str(), path, IMG_GetError());
+                failed = true;
+            }
+        }
+        if (game.status() != Game::ONGOING && !game.isAnimating()) {
+            break;
+        }
+    }
+
+    if (!renderTimes.empty()) {
+        std::vector<double> sorted = renderTimes;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for (double t : sorted) total += t;
+        auto percentile = [&sorted](double p) { return sorted[static_cast<size_t>(p * (sorted.size() - 1))]; };
+        std::printf("%zu frames, render mean %.1f us  p50 %.1f us  p95 %.1f us  p99 %.1f us  max %.1f us\n",
+            sorted.size(), total / sorted.size(), percentile(0.50), percentile(0.95), percentile(0.99), sorted.back());
+        std::printf("Final score %d - %d, %d moves left\n", game.getPlayerScore(Game::PLAYER_1),
+            game.getPlayerScore(Game::PLAYER_2), game.getMovesLeft());
+    }
+
+    if (timings) std::fclose(timings);
+    if (font) TTF_CloseFont(font);
+    textures.destroy();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(frame);
+    IMG_Quit();
+    TTF_Quit();
+    SDL_Quit();
+    return failed ? 1 : 0;
+}
+
 
 int main(int argc, char* argv[]) {
 
+    // Headless modes: no window, audio or assets
+    if (argc > 1 && std::strcmp(argv[1], "--server") == 0) {
+        return runServer(argc, argv);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--feed-bench") == 0) {
+        return runFeedBenchmark(argc, argv);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--tournament") == 0) {
+        return runTournamentCommand(argc, argv);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        return runRulesBenchmark();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--headless") == 0) {
+        return runHeadlessReplay(argc, argv);
+    }
+
     SDL_Init(SDL_INIT_VIDEO);
     TTF_Init();
     IMG_Init(IMG_INIT_PNG);
@@ -162,25 +526,15 @@ int main(int argc, char* argv[]) {
         SDL_WINDOWPOS_CENTERED,
         Game::WINDOW_WIDTH,
         Game::WINDOW_HEIGHT,
-        SDL_WINDOW_SHOWN);
+        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
 
     SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    SDL_RenderSetLogicalSize(renderer, Game::WINDOW_WIDTH, Game::WINDOW_HEIGHT); // Layout and mouse stay in window units at any size
 
-    // Load textures
-    SDL_Texture* blueTexture = LoadTexture(renderer, "assets/blue.png");
-    SDL_Texture* greenTexture = LoadTexture(renderer, "assets/green.png");
-    SDL_Texture* magentaTexture = LoadTexture(renderer, "assets/magenta.png");
-    SDL_Texture* redTexture = LoadTexture(renderer, "assets/red.png");
-    SDL_Texture* yellowTexture = LoadTexture(renderer, "assets/yellow.png");
-    SDL_Texture* backgroundTexture = LoadTexture(renderer, "assets/background.png");
-    SDL_Texture* startButtonTexture = LoadTexture(renderer, "assets/startbutton.png");
-    SDL_Texture* player1WinTexture = LoadTexture(renderer, "assets/player1win.png");
-    SDL_Texture* player2WinTexture = LoadTexture(renderer, "assets/player2win.png");
-    SDL_Texture* exitButtonTexture = LoadTexture(renderer, "assets/exitbutton.png");
-    SDL_Texture* restartButtonTexture = LoadTexture(renderer, "assets/restartbutton.png");
-    SDL_Texture* exitBackgroundTexture = LoadTexture(renderer, "assets/exitbackground.png");
-    SDL_Texture* startBackgroundTexture = LoadTexture(renderer, "assets/startbackground.png");
-    SDL_Texture* winBackgroundTexture = LoadTexture(renderer, "assets/winbackground.png");
+    // Load textures, kept pre-scaled to the size each is drawn at on this display
+    TextureCache textures(renderer, Game::WINDOW_WIDTH, Game::WINDOW_HEIGHT);
+    GameImages images;
+    bool imagesLoaded = loadGameImages(textures, images);
 
     // Load sounds with error checking
 
@@ -284,27 +638,11 @@ int main(int argc, char* argv[]) {
 
 
     // Handle texture loading errors
-    if (!blueTexture || !greenTexture || !magentaTexture || !redTexture || !yellowTexture ||
-        !backgroundTexture || !startButtonTexture || !player1WinTexture ||
-        !player2WinTexture || !exitButtonTexture || !restartButtonTexture ||
-        !exitBackgroundTexture || !startBackgroundTexture || !winBackgroundTexture) {
+    if (!imagesLoaded) {
         std::cerr << "Failed to load one or more textures. Exiting." << std::endl;
 
         // Cleanup textures and sounds if loading failed
-        if (blueTexture) SDL_DestroyTexture(blueTexture);
-        if (greenTexture) SDL_DestroyTexture(greenTexture);
-        if (magentaTexture) SDL_DestroyTexture(magentaTexture);
-        if (redTexture) SDL_DestroyTexture(redTexture);
-        if (yellowTexture) SDL_DestroyTexture(yellowTexture);
-        if (backgroundTexture) SDL_DestroyTexture(backgroundTexture);
-        if (startButtonTexture) SDL_DestroyTexture(startButtonTexture);
-        if (player1WinTexture) SDL_DestroyTexture(player1WinTexture);
-        if (player2WinTexture) SDL_DestroyTexture(player2WinTexture);
-        if (exitButtonTexture) SDL_DestroyTexture(exitButtonTexture);
-        if (restartButtonTexture) SDL_DestroyTexture(restartButtonTexture);
-        if (exitBackgroundTexture) SDL_DestroyTexture(exitBackgroundTexture);
-        if (startBackgroundTexture) SDL_DestroyTexture(startBackgroundTexture);
-        if (winBackgroundTexture) SDL_DestroyTexture(winBackgroundTexture);
+        textures.destroy();
 
         if (backgroundMusic) Mix_FreeMusic(backgroundMusic); // Keep cleanup for completeness, though backgroundMusic is nullptr
         if (buttonClickSound) Mix_FreeChunk(buttonClickSound);
@@ -328,19 +666,7 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    TTF_Font* font = nullptr;
-    const char* fontPaths[] = {
-        "arial.ttf",
-        "fonts/arial.ttf",
-        "C:/Windows/Fonts/arial.ttf",
-        nullptr
-    };
-
-    for (int i = 0; fontPaths[i]; i++) {
-        font = TTF_OpenFont(fontPaths[i], 24);
-        if (font) break;
-    }
-
+    TTF_Font* font = openFont();
     if (!font) {
         std::cerr << "Failed to load font: " << TTF_GetError() << std::endl;
         // Continue execution, but text rendering might fail
@@ -352,16 +678,41 @@ int main(int argc, char* argv[]) {
     Uint32 lastTime = SDL_GetTicks();
     GameState currentState = START_SCREEN;
 
+    // Checkpoints go to disk on a background thread; a match that was still going when the
+    // game last closed (or crashed) picks up where it left off
+    SnapshotWriter snapshotWriter(SNAPSHOT_PATH);
+    GameSnapshot snapshot;
+    auto checkpoint = [&]() {
+        game.saveSnapshot(snapshot);
+        snapshotWriter.save(snapshot);
+    };
+    if (readSnapshotFile(SNAPSHOT_PATH, snapshot) && snapshot.status == Game::ONGOING &&
+        snapshot.movesLeft < Game::MAX_MOVES && game.restoreSnapshot(snapshot)) {
+        currentState = ONGOING;
+        LOG_INFO("Resumed the saved match with %d moves left", game.getMovesLeft());
+    }
+    bool wasBusy = game.isBusy();
+    Match3::ScoreFileWatcher<Game::Scoring> scoreWatcher(SCORES_PATH);
+
     // Flag to track if the winner sound has been played
     bool winnerSoundPlayed = false;
 
+    // The start, game over and exit screens are drawn once per visit and then copied each frame
+    LayerCache menuLayer(renderer, Game::WINDOW_WIDTH, Game::WINDOW_HEIGHT);
+    GameState drawnState = currentState;
+
     while (running) {
         Uint32 currentTime = SDL_GetTicks();
         float deltaTime = (currentTime - lastTime) / 1000.0f;
         lastTime = currentTime;
 
         while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) running = false;
+            menuLayer.handleEvent(e);
+            textures.handleEvent(e);
+            if (e.type == SDL_QUIT) {
+                running = false;
+                if (currentState == ONGOING) checkpoint(); // Even mid-animation
+            }
 
             if (currentState == START_SCREEN) {
                 if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
@@ -387,8 +738,7 @@ int main(int argc, char* argv[]) {
             }
             else if (currentState == ONGOING) {
                 if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT &&
-                    game.status() == Game::ONGOING && !game.isAnimating() &&
-                    !game.isDropping() && !game.isCascading() && !game.isRefilling()) {
+                    game.status() == Game::ONGOING && !game.isBusy()) {
                     int x = e.button.x;
                     int y = e.button.y;
 
@@ -401,16 +751,16 @@ int main(int argc, char* argv[]) {
                         int row = (y - boardY) / (Game::GEM_SIZE + Game::GEM_SPACING);
                         int col = (x - boardX) / (Game::GEM_SIZE + Game::GEM_SPACING);
 
-                        // Debugging output
-                        std::cout << "Gem clicked: Row " << row << ", Col " << col << std::endl;
-                        std::cout << "Attempting to play gem click sound..." << std::endl;
+                        // Debugging output (compiled out of release builds)
+                        LOG_DEBUG("Gem clicked: Row %d, Col %d", row, col);
+                        LOG_DEBUG("Attempting to play gem click sound...");
 
                         // Play gem click sound BEFORE any game logic
                         if (gemClickSound) {
                             PlaySoundEffect(gemClickSound);
                         }
                         else {
-                            std::cerr << "gemClickSound is null!" << std::endl;
+                            LOG_WARN("gemClickSound is null!");
                         }
 
                         if (game.getSelectedRow() == -1) {
@@ -442,6 +792,7 @@ int main(int argc, char* argv[]) {
                         PlaySoundEffect(buttonClickSound);
                         currentState = START_SCREEN;
                         game.reset();
+                        checkpoint(); // The abandoned or finished match is not resumed
                         winnerSoundPlayed = false; // Reset the flag when restarting
                         if (backgroundMusic) Mix_ResumeMusic(); // Resume music
                     }
@@ -470,6 +821,7 @@ int main(int argc, char* argv[]) {
                         PlaySoundEffect(buttonClickSound);
                         currentState = START_SCREEN;
                         game.reset();
+                        checkpoint(); // The abandoned or finished match is not resumed
                         winnerSoundPlayed = false; // Reset the flag when restarting from exit menu
                         if (backgroundMusic) Mix_ResumeMusic(); // Resume music
                     }
@@ -482,6 +834,10 @@ int main(int argc, char* argv[]) {
                 }
             }
 
+            if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_h && currentState == ONGOING) {
+                game.toggleHint();
+            }
+
             if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE) {
                 if (currentState == ONGOING) { // Only go to game over from ongoing
                     currentState = GAME_OVER;
@@ -493,8 +849,25 @@ int main(int argc, char* argv[]) {
             }
         }
 
+        if (!game.isBusy()) {
+            std::string scoreError;
+            if (scoreWatcher.poll(scoreError)) {
+                LOG_INFO("Loaded scores from %s", SCORES_PATH);
+            }
+            else if (!scoreError.empty()) {
+                LOG_WARN("Kept the previous scores: %s", scoreError.c_str());
+            }
+        }
+
         game.update(deltaTime);
 
+        // Checkpoint every turn once its cascades have settled
+        bool busy = game.isBusy();
+        if (currentState == ONGOING && wasBusy && !busy) {
+            checkpoint();
+        }
+        wasBusy = busy;
+
         // State transitions
         if (currentState == ONGOING) {
             if (game.status() == Game::WIN || game.status() == Game::LOSE) { // Check for both win and lose
@@ -514,101 +887,85 @@ int main(int argc, char* argv[]) {
         SDL_SetRenderDrawColor(renderer, 40, 40, 40, 255);
         SDL_RenderClear(renderer);
 
+        if (currentState != drawnState) {
+            menuLayer.invalidate();
+            drawnState = currentState;
+        }
+
         if (currentState == START_SCREEN) {
-            SDL_RenderCopy(renderer, startBackgroundTexture, nullptr, nullptr);
+            menuLayer.draw(START_SCREEN, [&]() {
+                drawFullWindow(renderer, textures, images.startBackground);
 
-            int buttonWidth = 300 * 1.25;
-            int buttonHeight = 150 * 1.25;
-            int buttonX = (Game::WINDOW_WIDTH - buttonWidth) / 2;
-            int buttonY = (Game::WINDOW_HEIGHT - buttonHeight) / 2;
+                int buttonWidth = 300 * 1.25;
+                int buttonHeight = 150 * 1.25;
+                int buttonX = (Game::WINDOW_WIDTH - buttonWidth) / 2;
+                int buttonY = (Game::WINDOW_HEIGHT - buttonHeight) / 2;
 
-            SDL_Rect startButtonRect = { buttonX, buttonY, buttonWidth, buttonHeight };
-            SDL_RenderCopy(renderer, startButtonTexture, nullptr, &startButtonRect);
+                SDL_Rect startButtonRect = { buttonX, buttonY, buttonWidth, buttonHeight };
+                drawImage(renderer, textures, images.startButton, startButtonRect);
+            });
 
             // if (backgroundMusic) Mix_ResumeMusic(); // Original commented out
 
         }
         else if (currentState == ONGOING) {
-            SDL_RenderCopy(renderer, backgroundTexture, nullptr, nullptr);
-            game.draw(renderer, blueTexture, greenTexture, magentaTexture, redTexture, yellowTexture);
-
-            SDL_Color white = { 255, 255, 255, 255 };
-            SDL_Color red = { 255, 150, 150, 255 };
-            SDL_Color blue = { 150, 150, 255, 255 };
-
-            // Draw scores and info
-            if (font) { // Only render text if font is loaded
-                SDL_Color p1Color = (game.getCurrentPlayer() == Game::PLAYER_1) ? red : white;
-                std::string p1Text = "Player 1: " + std::to_string(game.getPlayerScore(Game::PLAYER_1));
-                renderText(renderer, font, p1Text, 50, 20, p1Color); // Original was 20, changed to 50
-
-                SDL_Color p2Color = (game.getCurrentPlayer() == Game::PLAYER_2) ? blue : white;
-                std::string p2Text = "Player 2: " + std::to_string(game.getPlayerScore(Game::PLAYER_2));
-                int p2Width = 0;
-                TTF_SizeText(font, p2Text.c_str(), &p2Width, nullptr);
-                renderText(renderer, font, p2Text, Game::WINDOW_WIDTH - p2Width - 50, 20, p2Color);
-
-                std::string targetText = "Target: " + std::to_string(Game::WIN_SCORE);
-                int targetWidth = 0;
-                TTF_SizeText(font, targetText.c_str(), &targetWidth, nullptr);
-                renderText(renderer, font, targetText, (Game::WINDOW_WIDTH - targetWidth) / 2, 20, white);
-
-                std::string movesText = "Moves Left: " + std::to_string(game.getMovesLeft());
-                int movesWidth = 0;
-                TTF_SizeText(font, movesText.c_str(), &movesWidth, nullptr);
-                renderText(renderer, font, movesText, (Game::WINDOW_WIDTH - movesWidth) / 2, 50, white);
-            }
-
+            drawMatchScreen(renderer, font, game, textures, images);
         }
         else if (currentState == GAME_OVER) {
-            SDL_RenderCopy(renderer, backgroundTexture, nullptr, nullptr); // Draw game board behind win screen
-            game.draw(renderer, blueTexture, greenTexture, magentaTexture, redTexture, yellowTexture); // Draw game board behind win screen
-            SDL_RenderCopy(renderer, winBackgroundTexture, nullptr, nullptr);
+            if (game.isAnimating()) {
+                menuLayer.invalidate(); // The board can still be settling behind the overlay after Escape
+            }
+            menuLayer.draw(GAME_OVER, [&]() {
+                drawFullWindow(renderer, textures, images.background); // Draw game board behind win screen
+                drawBoard(renderer, game, textures, images, false); // Draw game board behind win screen
+                drawFullWindow(renderer, textures, images.winBackground);
 
-            SDL_Rect winRect = { 100, 200, Game::WINDOW_WIDTH - 200, 200 };
-            SDL_Rect playerWinDrawRect = winRect;
+                SDL_Rect winRect = { 100, 200, Game::WINDOW_WIDTH - 200, 200 };
+                SDL_Rect playerWinDrawRect = winRect;
 
-            if (game.status() == Game::WIN) {
-                if (game.getPlayerScore(Game::PLAYER_1) >= Game::WIN_SCORE) {
-                    SDL_RenderCopy(renderer, player1WinTexture, nullptr, &playerWinDrawRect);
+                if (game.status() == Game::WIN) {
+                    if (game.getPlayerScore(Game::PLAYER_1) >= Game::WIN_SCORE) {
+                        drawImage(renderer, textures, images.player1Win, playerWinDrawRect);
+                    }
+                    else {
+                        drawImage(renderer, textures, images.player2Win, playerWinDrawRect);
+                    }
                 }
-                else {
-                    SDL_RenderCopy(renderer, player2WinTexture, nullptr, &playerWinDrawRect);
+                // Optionally display "Game Over" text if it was a lose state
+                else if (game.status() == Game::LOSE && font) {
+                    SDL_Color white = { 255, 255, 255, 255 };
+                    std::string gameOverText = "Game Over";
+                    int gameOverWidth = 0;
+                    int gameOverHeight = 0;
+                    TTF_SizeText(font, gameOverText.c_str(), &gameOverWidth, &gameOverHeight);
+                    renderText(renderer, font, gameOverText, (Game::WINDOW_WIDTH - gameOverWidth) / 2, winRect.y + winRect.h / 2 - gameOverHeight / 2, white);
                 }
-            }
-            // Optionally display "Game Over" text if it was a lose state
-            else if (game.status() == Game::LOSE && font) {
-                SDL_Color white = { 255, 255, 255, 255 };
-                std::string gameOverText = "Game Over";
-                int gameOverWidth = 0;
-                int gameOverHeight = 0;
-                TTF_SizeText(font, gameOverText.c_str(), &gameOverWidth, &gameOverHeight);
-                renderText(renderer, font, gameOverText, (Game::WINDOW_WIDTH - gameOverWidth) / 2, winRect.y + winRect.h / 2 - gameOverHeight / 2, white);
-            }
 
-            int buttonWidth = 250;
-            int buttonHeight = 60;
-            int buttonX = (Game::WINDOW_WIDTH - buttonWidth) / 2; // Center the buttons horizontally
-            int buttonYOffset = winRect.y + winRect.h + 20; // Vertical offset below win text/image
+                int buttonWidth = 250;
+                int buttonHeight = 60;
+                int buttonX = (Game::WINDOW_WIDTH - buttonWidth) / 2; // Center the buttons horizontally
+                int buttonYOffset = winRect.y + winRect.h + 20; // Vertical offset below win text/image
 
-            SDL_Rect restartButtonPos = { buttonX, buttonYOffset, buttonWidth, buttonHeight }; // Restart above Exit
-            SDL_Rect exitButtonPos = { buttonX, buttonYOffset + buttonHeight + 10, buttonWidth, buttonHeight }; // Exit below Restart (added spacing)
-
-            SDL_RenderCopy(renderer, restartButtonTexture, nullptr, &restartButtonPos);
-            SDL_RenderCopy(renderer, exitButtonTexture, nullptr, &exitButtonPos);
+                SDL_Rect restartButtonPos = { buttonX, buttonYOffset, buttonWidth, buttonHeight }; // Restart above Exit
+                SDL_Rect exitButtonPos = { buttonX, buttonYOffset + buttonHeight + 10, buttonWidth, buttonHeight }; // Exit below Restart (added spacing)
 
+                drawImage(renderer, textures, images.restartButton, restartButtonPos);
+                drawImage(renderer, textures, images.exitButton, exitButtonPos);
+            });
         }
         else if (currentState == EXIT_MENU) {
-            SDL_RenderCopy(renderer, exitBackgroundTexture, nullptr, nullptr);
+            menuLayer.draw(EXIT_MENU, [&]() {
+                drawFullWindow(renderer, textures, images.exitBackground);
 
-            int buttonWidth = 200; // Use 200 based on rendering
-            int buttonHeight = 50; // Use 50 based on rendering
+                int buttonWidth = 200; // Use 200 based on rendering
+                int buttonHeight = 50; // Use 50 based on rendering
 
-            SDL_Rect exitButtonRect = { Game::WINDOW_WIDTH / 2 - 100, Game::WINDOW_HEIGHT / 2 - 60, buttonWidth, buttonHeight };
-            SDL_Rect restartButtonRect = { Game::WINDOW_WIDTH / 2 - 100, Game::WINDOW_HEIGHT / 2 + 10, buttonWidth, buttonHeight };
+                SDL_Rect exitButtonRect = { Game::WINDOW_WIDTH / 2 - 100, Game::WINDOW_HEIGHT / 2 - 60, buttonWidth, buttonHeight };
+                SDL_Rect restartButtonRect = { Game::WINDOW_WIDTH / 2 - 100, Game::WINDOW_HEIGHT / 2 + 10, buttonWidth, buttonHeight };
 
-            SDL_RenderCopy(renderer, exitButtonTexture, nullptr, &exitButtonRect);
-            SDL_RenderCopy(renderer, restartButtonTexture, nullptr, &restartButtonRect);
+                drawImage(renderer, textures, images.exitButton, exitButtonRect);
+                drawImage(renderer, textures, images.restartButton, restartButtonRect);
+            });
         }
 
         SDL_RenderPresent(renderer);
@@ -616,6 +973,8 @@ int main(int argc, char* argv[]) {
     }
 
     // Cleanup
+    menuLayer.destroy();
+    textures.destroy();
     if (font) TTF_CloseFont(font);
     if (backgroundMusic) Mix_FreeMusic(backgroundMusic);
     if (buttonClickSound) Mix_FreeChunk(buttonClickSound);
@@ -637,5 +996,8 @@ int main(int argc, char* argv[]) {
     SDL_DestroyWindow(window);
     SDL_Quit();
 
+    snapshotWriter.stop(); // Before the logger goes, so a failed final checkpoint is still reported
+    Logger::instance().shutdown(); // Flush queued log messages
+
     return 0;
 }
@@ -0,0 +1,112 @@
+// particles.cpp
+
+#include "particles.h"
+#include <cmath>
+
+namespace {
+    const float GRAVITY = 900.0f; // Pixels per second squared
+    const float PARTICLE_SIZE = 4.0f;
+}
+
+ParticleSystem::ParticleSystem() : liveCount(0), rngState(0x12345678u),
+posX(MAX_PARTICLES), posY(MAX_PARTICLES), velX(MAX_PARTICLES), velY(MAX_PARTICLES),
+life(MAX_PARTICLES), inverseMaxLife(MAX_PARTICLES),
+red(MAX_PARTICLES), green(MAX_PARTICLES), blue(MAX_PARTICLES),
+vertices(MAX_PARTICLES * 4), indices(MAX_PARTICLES * 6) {
+    for (int i = 0; i < MAX_PARTICLES; ++i) {
+        int base = i * 4;
+        indices[i * 6 + 0] = base;
+        indices[i * 6 + 1] = base + 1;
+        indices[i * 6 + 2] = base + 2;
+        indices[i * 6 + 3] = base + 2;
+        indices[i * 6 + 4] = base + 3;
+        indices[i * 6 + 5] = base;
+    }
+    for (SDL_Vertex& vertex : vertices) {
+        vertex.tex_coord = { 0.0f, 0.0f };
+    }
+}
+
+float ParticleSystem::randomFloat(float low, float high) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return low + (high - low) * static_cast<float>(rngState & 0xFFFFFF) / static_cast<float>(0xFFFFFF);
+}
+
+void ParticleSystem::emit(float x, float y, SDL_Color color, int count) {
+    for (int n = 0; n < count && liveCount < MAX_PARTICLES; ++n) {
+        int i = liveCount++;
+        float angle = randomFloat(0.0f, 6.2831853f);
+        float speed = randomFloat(60.0f, 320.0f);
+        posX[i] = x;
+        posY[i] = y;
+        velX[i] = std::cos(angle) * speed;
+        velY[i] = std::sin(angle) * speed - 150.0f; // Kick upward a little before gravity takes over
+        life[i] = randomFloat(0.4f, 0.9f);
+        inverseMaxLife[i] = 1.0f / life[i];
+        red[i] = color.r;
+        green[i] = color.g;
+        blue[i] = color.b;
+    }
+}
+
+void ParticleSystem::update(float deltaTime) {
+    const int n = liveCount;
+    float* px = posX.data();
+    float* py = posY.data();
+    float* vx = velX.data();
+    float* vy = velY.data();
+    float* lf = life.data();
+
+    // Branch-free streams over the live range
+    for (int i = 0; i < n; ++i) {
+        vy[i] += GRAVITY * deltaTime;
+    }
+    for (int i = 0; i < n; ++i) {
+        px[i] += vx[i] * deltaTime;
+        py[i] += vy[i] * deltaTime;
+        lf[i] -= deltaTime;
+    }
+
+    // Retire dead particles by moving the last live one into their slot
+    for (int i = 0; i < liveCount;) {
+        if (lf[i] <= 0.0f) {
+            int last = --liveCount;
+            px[i] = px[last];
+            py[i] = py[last];
+            vx[i] = vx[last];
+            vy[i] = vy[last];
+            lf[i] = lf[last];
+            inverseMaxLife[i] = inverseMaxLife[last];
+            red[i] = red[last];
+            green[i] = green[last];
+            blue[i] = blue[last];
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+void ParticleSystem::draw(SDL_Renderer* renderer) {
+    if (liveCount == 0) return;
+
+    const float half = PARTICLE_SIZE * 0.5f;
+    for (int i = 0; i < liveCount; ++i) {
+        float fade = life[i] * inverseMaxLife[i];
+        SDL_Color color = { red[i], green[i], blue[i], static_cast<Uint8>(255.0f * (fade > 1.0f ? 1.0f : fade)) };
+        SDL_Vertex* quad = &vertices[i * 4];
+        quad[0].position = { posX[i] - half, posY[i] - half };
+        quad[1].position = { posX[i] + half, posY[i] - half };
+        quad[2].position = { posX[i] + half, posY[i] + half };
+        quad[3].position = { posX[i] - half, posY[i] + half };
+        quad[0].color = color;
+        quad[1].color = color;
+        quad[2].color = color;
+        quad[3].color = color;
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(renderer, nullptr, vertices.data(), liveCount * 4, indices.data(), liveCount * 6);
+}
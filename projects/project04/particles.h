@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <SDL2/SDL.h>
+
+// Burst particles for matches and cascades.
+// Every attribute lives in its own preallocated array (structure of arrays) so the update
+// loops are plain float streams the compiler can vectorize, and all live particles are
+// drawn as colored quads in a single SDL_RenderGeometry call.
+class ParticleSystem {
+public:
+    static const int MAX_PARTICLES = 100000;
+
+    ParticleSystem();
+
+    // Spawns count particles at (x, y) flying outward; extra particles are dropped once the pool is full
+    void emit(float x, float y, SDL_Color color, int count);
+
+    // Moves, fades and retires particles
+    void update(float deltaTime);
+
+    void draw(SDL_Renderer* renderer);
+
+    void clear() { liveCount = 0; }
+    int size() const { return liveCount; }
+
+private:
+    int liveCount; // Live particles are packed into [0, liveCount)
+    uint32_t rngState;
+
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> life; // Seconds left
+    std::vector<float> inverseMaxLife; // 1 / starting life, for the fade
+    std::vector<Uint8> red, green, blue;
+
+    std::vector<SDL_Vertex> vertices; // Four per particle, rebuilt every draw
+    std::vector<int> indices; // Two triangles per particle, built once
+
+    float randomFloat(float low, float high);
+};
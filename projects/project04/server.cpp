@@ -0,0 +1,661 @@
+// server.cpp
+
+#include "server.h"
+#include "logger.h"
+#include "../common/board_codec.h"
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+    const int N = VectorEnv::GRID_SIZE;
+    const int CELLS = VectorEnv::CELLS;
+    const size_t PACKED_BOARD_SIZE = (CELLS * BoardCodec::BITS_PER_CELL + 7) / 8;
+    const size_t JOIN_SIZE = 3;
+    const size_t MOVE_SIZE = 4;
+    const size_t STATE_SIZE = 14 + PACKED_BOARD_SIZE;
+    const size_t DELTA_HEADER_SIZE = 14;
+    const size_t READ_CHUNK = 16 * 1024;
+    const size_t MAX_PENDING_OUTPUT = 4 << 20; // A client this far behind is disconnected (a keyframe of every room fits)
+    const int MAX_EVENTS = 1024;
+    const double STATS_INTERVAL_SECONDS = 5.0;
+
+#ifdef _WIN32
+    const socket_t BAD_SOCKET = INVALID_SOCKET;
+    void closeSocket(socket_t sock) { closesocket(sock); }
+    bool wouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+    void setNonBlocking(socket_t sock) {
+        u_long enable = 1;
+        ioctlsocket(sock, FIONBIO, &enable);
+    }
+    const int SEND_FLAGS = 0;
+#else
+    const socket_t BAD_SOCKET = -1;
+    void closeSocket(socket_t sock) { close(sock); }
+    bool wouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+    void setNonBlocking(socket_t sock) {
+        fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+    }
+    const int SEND_FLAGS = MSG_NOSIGNAL;
+#endif
+
+    void writeU16(uint8_t* out, uint32_t value) {
+        out[0] = static_cast<uint8_t>(value);
+        out[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    void writeU32(uint8_t* out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+
+    void writeU64(uint8_t* out, uint64_t value) {
+        for (int i = 0; i < 8; ++i) out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+
+    uint32_t readU16(const uint8_t* in) {
+        return in[0] | (static_cast<uint32_t>(in[1]) << 8);
+    }
+
+    RoomServer* activeServer = nullptr;
+
+    void handleSignal(int) {
+        if (activeServer) activeServer->stop();
+    }
+}
+
+// Readiness notification for the listener and every client socket.
+// Ids are connection indices; the listener uses LISTENER_ID.
+class RoomServer::Poller {
+public:
+    static const uint32_t LISTENER_ID = 0xFFFFFFFFu;
+
+    struct Event {
+        uint32_t id;
+        bool readable; // Also set for hang-ups and errors so the read path notices them
+        bool writable;
+    };
+
+#ifdef _WIN32
+    bool open() { return true; }
+
+    void add(socket_t sock, uint32_t id) {
+        WSAPOLLFD entry;
+        entry.fd = sock;
+        entry.events = POLLRDNORM;
+        entry.revents = 0;
+        if (id != LISTENER_ID) {
+            if (id >= slotOf.size()) slotOf.resize(id + 1, -1);
+            slotOf[id] = static_cast<int>(fds.size());
+        }
+        fds.push_back(entry);
+        ids.push_back(id);
+    }
+
+    void setWritable(socket_t, uint32_t id, bool writable) {
+        fds[slotOf[id]].events = static_cast<SHORT>(writable ? (POLLRDNORM | POLLWRNORM) : POLLRDNORM);
+    }
+
+    void remove(socket_t, uint32_t id) {
+        int slot = slotOf[id];
+        int last = static_cast<int>(fds.size()) - 1;
+        fds[slot] = fds[last];
+        ids[slot] = ids[last];
+        if (ids[slot] != LISTENER_ID) slotOf[ids[slot]] = slot;
+        fds.pop_back();
+        ids.pop_back();
+        slotOf[id] = -1;
+    }
+
+    int wait(Event* events, int maxEvents, int timeoutMs) {
+        if (WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), timeoutMs) <= 0) return 0;
+        int count = 0;
+        for (size_t i = 0; i < fds.size() && count < maxEvents; ++i) {
+            short revents = fds[i].revents;
+            if (revents == 0) continue;
+            events[count].id = ids[i];
+            events[count].readable = (revents & (POLLRDNORM | POLLHUP | POLLERR)) != 0;
+            events[count].writable = (revents & POLLWRNORM) != 0;
+            count++;
+        }
+        return count;
+    }
+
+private:
+    std::vector<WSAPOLLFD> fds;
+    std::vector<uint32_t> ids;
+    std::vector<int> slotOf; // Index into fds for each connection id
+#else
+    Poller() : epollFd(-1) {}
+    ~Poller() { if (epollFd >= 0) close(epollFd); }
+
+    bool open() {
+        epollFd = epoll_create1(0);
+        return epollFd >= 0;
+    }
+
+    void add(socket_t sock, uint32_t id) {
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u32 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, sock, &event);
+    }
+
+    void setWritable(socket_t sock, uint32_t id, bool writable) {
+        epoll_event event = {};
+        event.events = writable ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        event.data.u32 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, sock, &event);
+    }
+
+    void remove(socket_t sock, uint32_t) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, sock, nullptr);
+    }
+
+    int wait(Event* events, int maxEvents, int timeoutMs) {
+        epoll_event ready[MAX_EVENTS];
+        int count = epoll_wait(epollFd, ready, std::min(maxEvents, MAX_EVENTS), timeoutMs);
+        for (int i = 0; i < count; ++i) {
+            events[i].id = ready[i].data.u32;
+            events[i].readable = (ready[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0;
+            events[i].writable = (ready[i].events & EPOLLOUT) != 0;
+        }
+        return std::max(count, 0);
+    }
+
+private:
+    int epollFd;
+#endif
+};
+
+RoomServer::RoomServer(int roomCount, int threadCount, uint32_t seed) : env(threadCount),
+feedEncoder(std::max(1, std::min(roomCount, static_cast<int>(MAX_ROOMS)))), listener(BAD_SOCKET), running(false),
+movesThisInterval(0), poller(new Poller()) {
+    roomCount = std::max(1, std::min(roomCount, static_cast<int>(MAX_ROOMS)));
+    boards.resize(static_cast<size_t>(roomCount) * CELLS);
+    previousBoards.resize(boards.size());
+    env.setRecordCascades(true); // For the spectator feed
+    env.reset(roomCount, boards.data(), seed);
+
+    rooms.resize(roomCount);
+    for (Room& room : rooms) {
+        room.seats[0] = -1;
+        room.seats[1] = -1;
+    }
+    actions.assign(roomCount, -1);
+    rewards.resize(roomCount);
+    dones.resize(roomCount);
+    moveArrival.resize(roomCount);
+    latencyHistogram.assign(LATENCY_BUCKETS + 1, 0); // Last bucket collects everything slower
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+}
+
+RoomServer::~RoomServer() {
+    for (size_t id = 0; id < connections.size(); ++id) {
+        if (connections[id].open) closeSocket(connections[id].sock);
+    }
+    if (listener != BAD_SOCKET) closeSocket(listener);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool RoomServer::listen(uint16_t port) {
+    if (!poller->open()) {
+        std::fprintf(stderr, "Failed to create the socket poller\n");
+        return false;
+    }
+
+    listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listener == BAD_SOCKET) {
+        std::fprintf(stderr, "Failed to create the listening socket\n");
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Local play only
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener, SOMAXCONN) != 0) {
+        std::fprintf(stderr, "Failed to listen on port %u\n", static_cast<unsigned>(port));
+        return false;
+    }
+    setNonBlocking(listener);
+    poller->add(listener, Poller::LISTENER_ID);
+    return true;
+}
+
+void RoomServer::run() {
+    running.store(true);
+    std::vector<Poller::Event> events(MAX_EVENTS);
+    Clock::time_point statsStart = Clock::now();
+
+    while (running.load()) {
+        int count = poller->wait(events.data(), MAX_EVENTS, 100);
+        for (int i = 0; i < count; ++i) {
+            const Poller::Event& event = events[i];
+            if (event.id == Poller::LISTENER_ID) {
+                acceptConnections();
+                continue;
+            }
+            int id = static_cast<int>(event.id);
+            if (event.writable && connections[id].open) flushConnection(id);
+            if (event.readable && connections[id].open) readConnection(id);
+        }
+
+        applyQueuedMoves();
+
+        for (int id : dirtyConnections) {
+            connections[id].dirty = false;
+            if (connections[id].open) flushConnection(id);
+        }
+        dirtyConnections.clear();
+
+        // Replies for this tick have been handed to the kernel
+        Clock::time_point now = Clock::now();
+        for (int room : movedRooms) {
+            recordLatency(moveArrival[room], now);
+        }
+        movedRooms.clear();
+
+        double elapsed = std::chrono::duration<double>(now - statsStart).count();
+        if (elapsed >= STATS_INTERVAL_SECONDS) {
+            logStats(elapsed);
+            statsStart = now;
+        }
+    }
+}
+
+void RoomServer::acceptConnections() {
+    while (true) {
+        socket_t sock = accept(listener, nullptr, nullptr);
+        if (sock == BAD_SOCKET) return; // Nothing left to accept
+        setNonBlocking(sock);
+        int noDelay = 1; // Replies are tiny and latency matters more than packet count
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+        int id;
+        if (!freeConnections.empty()) {
+            id = freeConnections.back();
+            freeConnections.pop_back();
+        }
+        else {
+            id = static_cast<int>(connections.size());
+            connections.emplace_back();
+        }
+        Connection& connection = connections[id];
+        connection.sock = sock;
+        connection.open = true;
+        connection.wantsWrite = false;
+        connection.dirty = false;
+        connection.subscribed = false;
+        connection.input.clear();
+        connection.output.clear();
+        connection.outputSent = 0;
+        connection.rooms.clear();
+        poller->add(sock, static_cast<uint32_t>(id));
+    }
+}
+
+void RoomServer::readConnection(int id) {
+    Connection& connection = connections[id];
+    while (true) {
+        size_t used = connection.input.size();
+        connection.input.resize(used + READ_CHUNK);
+        int received = recv(connection.sock, reinterpret_cast<char*>(connection.input.data() + used), static_cast<int>(READ_CHUNK), 0);
+        if (received > 0) {
+            connection.input.resize(used + received);
+            if (static_cast<size_t>(received) < READ_CHUNK) break; // Drained the socket
+            continue;
+        }
+        connection.input.resize(used);
+        if (received == 0 || !wouldBlock()) {
+            closeConnection(id); // Peer hung up or the socket failed
+            return;
+        }
+        break;
+    }
+
+    if (!handleMessages(id)) {
+        closeConnection(id);
+    }
+}
+
+bool RoomServer::handleMessages(int id) {
+    Clock::time_point arrival = Clock::now();
+    std::vector<uint8_t>& input = connections[id].input;
+    size_t pos = 0;
+
+    while (pos < input.size()) {
+        const uint8_t* message = input.data() + pos;
+        size_t available = input.size() - pos;
+        if (message[0] == MSG_JOIN) {
+            if (available < JOIN_SIZE) break;
+            handleJoin(id, static_cast<int>(readU16(message + 1)));
+            pos += JOIN_SIZE;
+        }
+        else if (message[0] == MSG_MOVE) {
+            if (available < MOVE_SIZE) break;
+            handleMove(id, static_cast<int>(readU16(message + 1)), message[3], arrival);
+            pos += MOVE_SIZE;
+        }
+        else if (message[0] == MSG_SUBSCRIBE) {
+            handleSubscribe(id);
+            pos += 1;
+        }
+        else {
+            return false;
+        }
+    }
+
+    input.erase(input.begin(), input.begin() + pos); // Keep a partial message for the next read
+    return true;
+}
+
+void RoomServer::handleJoin(int id, int room) {
+    if (room >= static_cast<int>(rooms.size())) {
+        sendReject(id, room, BAD_ROOM);
+        return;
+    }
+
+    Room& target = rooms[room];
+    uint8_t seat;
+    if (target.seats[0] == -1) {
+        target.seats[0] = id;
+        seat = 0;
+    }
+    else if (target.seats[1] == -1) {
+        target.seats[1] = id; // The same connection may take both seats for hot-seat play
+        seat = 1;
+    }
+    else if (std::find(target.spectators.begin(), target.spectators.end(), id) != target.spectators.end()) {
+        seat = SPECTATOR; // Already watching; just resend the board
+    }
+    else if (static_cast<int>(target.spectators.size()) < MAX_SPECTATORS) {
+        target.spectators.push_back(id);
+        seat = SPECTATOR;
+    }
+    else {
+        sendReject(id, room, ROOM_FULL);
+        return;
+    }
+
+    if (std::find(connections[id].rooms.begin(), connections[id].rooms.end(), room) == connections[id].rooms.end()) {
+        connections[id].rooms.push_back(room);
+    }
+    sendState(id, room, seat);
+}
+
+void RoomServer::handleMove(int id, int room, int action, Clock::time_point arrival) {
+    if (room >= static_cast<int>(rooms.size())) {
+        sendReject(id, room, BAD_ROOM);
+        return;
+    }
+
+    const Room& target = rooms[room];
+    if (target.seats[0] != id && target.seats[1] != id) {
+        sendReject(id, room, NOT_SEATED);
+        return;
+    }
+    if (target.seats[env.currentPlayers()[room]] != id) {
+        sendReject(id, room, NOT_YOUR_TURN);
+        return;
+    }
+    if (actions[room] != -1) {
+        sendReject(id, room, MOVE_PENDING); // The turn has not been applied yet
+        return;
+    }
+    if (!env.isLegal(room, action)) {
+        sendReject(id, room, ILLEGAL_MOVE);
+        return;
+    }
+
+    actions[room] = action;
+    moveArrival[room] = arrival;
+    movedRooms.push_back(room);
+}
+
+void RoomServer::handleSubscribe(int id) {
+    if (connections[id].subscribed) return;
+    connections[id].subscribed = true;
+    feedSubscribers.push_back(id);
+
+    // Every room starts with a keyframe so the subscriber can decode what follows
+    std::vector<uint8_t> keyframes;
+    keyframes.reserve(rooms.size() * SpectatorFeed::KEYFRAME_SIZE);
+    for (int room = 0; room < static_cast<int>(rooms.size()); ++room) {
+        feedEncoder.keyframe(env, room, keyframes);
+    }
+    queueOutput(id, keyframes.data(), keyframes.size());
+}
+
+void RoomServer::applyQueuedMoves() {
+    if (movedRooms.empty()) return;
+
+    uint8_t movers[MAX_ROOMS / 8] = {}; // Bit per room: whether player 2 made the move
+    for (int room : movedRooms) {
+        std::memcpy(&previousBoards[static_cast<size_t>(room) * CELLS], &boards[static_cast<size_t>(room) * CELLS], CELLS);
+        if (env.currentPlayers()[room]) movers[room >> 3] |= static_cast<uint8_t>(1 << (room & 7));
+    }
+
+    env.step(actions.data(), rewards.data(), dones.data(), movedRooms.data(), static_cast<int>(movedRooms.size()));
+
+    uint8_t delta[DELTA_HEADER_SIZE + PACKED_BOARD_SIZE];
+    for (int room : movedRooms) {
+        const uint8_t* before = &previousBoards[static_cast<size_t>(room) * CELLS];
+        const uint8_t* after = &boards[static_cast<size_t>(room) * CELLS];
+
+        uint64_t changed = 0;
+        std::memset(delta + DELTA_HEADER_SIZE, 0, PACKED_BOARD_SIZE);
+        size_t changedCount = 0;
+        for (int i = 0; i < CELLS; ++i) {
+            if (before[i] != after[i]) {
+                changed |= uint64_t(1) << i;
+                BoardCodec::setCell(delta + DELTA_HEADER_SIZE, changedCount++, after[i]);
+            }
+        }
+
+        uint8_t flags = (movers[room >> 3] >> (room & 7)) & 1 ? FLAG_PLAYER_2 : 0;
+        if (dones[room]) {
+            flags |= FLAG_FINISHED;
+            if (env.lastOutcomes()[room] == VectorEnv::WIN) flags |= FLAG_WON;
+        }
+        delta[0] = MSG_DELTA;
+        writeU16(delta + 1, static_cast<uint32_t>(room));
+        delta[3] = flags;
+        writeU16(delta + 4, static_cast<uint32_t>(rewards[room] / VectorEnv::POINTS_PER_GEM));
+        writeU64(delta + 6, changed);
+        size_t size = DELTA_HEADER_SIZE + (changedCount * BoardCodec::BITS_PER_CELL + 7) / 8;
+
+        const Room& target = rooms[room];
+        for (int seat = 0; seat < 2; ++seat) {
+            if (target.seats[seat] != -1 && (seat == 0 || target.seats[1] != target.seats[0])) {
+                queueOutput(target.seats[seat], delta, size);
+            }
+        }
+        for (int spectator : target.spectators) {
+            queueOutput(spectator, delta, size);
+        }
+    }
+
+    if (!feedSubscribers.empty()) {
+        feed.clear();
+        for (int room : movedRooms) {
+            feedEncoder.turn(env, room, actions[room], dones[room], feed);
+        }
+        for (int subscriber : feedSubscribers) {
+            queueOutput(subscriber, feed.data(), feed.size());
+        }
+    }
+
+    for (int room : movedRooms) {
+        actions[room] = -1;
+    }
+    movesThisInterval += movedRooms.size();
+}
+
+void RoomServer::sendState(int id, int room, uint8_t seat) {
+    uint8_t state[STATE_SIZE];
+    state[0] = MSG_STATE;
+    writeU16(state + 1, static_cast<uint32_t>(room));
+    state[3] = seat;
+    state[4] = env.currentPlayers()[room];
+    state[5] = static_cast<uint8_t>(env.movesLeft()[room]);
+    writeU32(state + 6, static_cast<uint32_t>(env.player1Scores()[room]));
+    writeU32(state + 10, static_cast<uint32_t>(env.player2Scores()[room]));
+    const uint8_t (*board)[N] = reinterpret_cast<const uint8_t (*)[N]>(&boards[static_cast<size_t>(room) * CELLS]);
+    BoardCodec::pack(board, N, N, state + 14);
+    queueOutput(id, state, STATE_SIZE);
+}
+
+void RoomServer::sendReject(int id, int room, uint8_t reason) {
+    uint8_t reject[4];
+    reject[0] = MSG_REJECT;
+    writeU16(reject + 1, static_cast<uint32_t>(room));
+    reject[3] = reason;
+    queueOutput(id, reject, sizeof(reject));
+}
+
+void RoomServer::queueOutput(int id, const uint8_t* data, size_t size) {
+    Connection& connection = connections[id];
+    if (!connection.open) return;
+    connection.output.insert(connection.output.end(), data, data + size);
+    if (!connection.dirty) {
+        connection.dirty = true;
+        dirtyConnections.push_back(id);
+    }
+}
+
+void RoomServer::flushConnection(int id) {
+    Connection& connection = connections[id];
+    while (connection.outputSent < connection.output.size()) {
+        size_t remaining = connection.output.size() - connection.outputSent;
+        int sent = send(connection.sock, reinterpret_cast<const char*>(connection.output.data() + connection.outputSent),
+            static_cast<int>(remaining), SEND_FLAGS);
+        if (sent > 0) {
+            connection.outputSent += sent;
+            continue;
+        }
+        if (!wouldBlock()) {
+            closeConnection(id);
+            return;
+        }
+        break;
+    }
+
+    if (connection.outputSent == connection.output.size()) {
+        connection.output.clear();
+        connection.outputSent = 0;
+    }
+    else if (connection.output.size() - connection.outputSent > MAX_PENDING_OUTPUT) {
+        LOG_WARN("Disconnecting client %d: %zu bytes of unread updates", id, connection.output.size() - connection.outputSent);
+        closeConnection(id);
+        return;
+    }
+
+    bool wantsWrite = !connection.output.empty();
+    if (wantsWrite != connection.wantsWrite) {
+        connection.wantsWrite = wantsWrite;
+        poller->setWritable(connection.sock, static_cast<uint32_t>(id), wantsWrite);
+    }
+}
+
+void RoomServer::closeConnection(int id) {
+    Connection& connection = connections[id];
+    if (!connection.open) return;
+
+    for (int room : connection.rooms) {
+        Room& target = rooms[room];
+        for (int seat = 0; seat < 2; ++seat) {
+            if (target.seats[seat] == id) target.seats[seat] = -1;
+        }
+        target.spectators.erase(std::remove(target.spectators.begin(), target.spectators.end(), id), target.spectators.end());
+        // A move it queued this tick is still applied; the delta just has one reader fewer
+    }
+
+    poller->remove(connection.sock, static_cast<uint32_t>(id));
+    closeSocket(connection.sock);
+    if (connection.subscribed) {
+        feedSubscribers.erase(std::remove(feedSubscribers.begin(), feedSubscribers.end(), id), feedSubscribers.end());
+        connection.subscribed = false;
+    }
+    connection.open = false;
+    connection.rooms.clear();
+    connection.input.clear();
+    connection.output.clear();
+    connection.outputSent = 0;
+    freeConnections.push_back(id);
+}
+
+void RoomServer::recordLatency(Clock::time_point arrival, Clock::time_point now) {
+    long long micros = std::chrono::duration_cast<std::chrono::microseconds>(now - arrival).count();
+    int bucket = static_cast<int>(std::min<long long>(micros / LATENCY_BUCKET_US, LATENCY_BUCKETS));
+    latencyHistogram[bucket]++;
+}
+
+void RoomServer::logStats(double seconds) {
+    if (movesThisInterval > 0) {
+        // Upper edge of the bucket holding the 99th percentile move
+        uint64_t target = movesThisInterval - movesThisInterval / 100;
+        uint64_t seen = 0;
+        int bucket = 0;
+        for (; bucket < LATENCY_BUCKETS; ++bucket) {
+            seen += latencyHistogram[bucket];
+            if (seen >= target) break;
+        }
+        int openConnections = static_cast<int>(connections.size() - freeConnections.size());
+        if (bucket < LATENCY_BUCKETS) {
+            LOG_INFO("%d clients, %.0f moves/s, p99 move latency %d us", openConnections,
+                movesThisInterval / seconds, (bucket + 1) * LATENCY_BUCKET_US);
+        }
+        else {
+            LOG_INFO("%d clients, %.0f moves/s, p99 move latency over %d us", openConnections,
+                movesThisInterval / seconds, LATENCY_BUCKETS * LATENCY_BUCKET_US);
+        }
+    }
+    std::fill(latencyHistogram.begin(), latencyHistogram.end(), 0);
+    movesThisInterval = 0;
+}
+
+int runServer(int argc, char* argv[]) {
+    uint16_t port = argc > 2 ? static_cast<uint16_t>(std::atoi(argv[2])) : 7777;
+    int roomCount = argc > 3 ? std::atoi(argv[3]) : 10000;
+    int threadCount = argc > 4 ? std::atoi(argv[4]) : 0;
+
+    RoomServer server(roomCount, threadCount, 12345u);
+    if (!server.listen(port)) {
+        return 1;
+    }
+
+    activeServer = &server;
+    std::signal(SIGINT, handleSignal);
+    LOG_INFO("Serving %d rooms on 127.0.0.1:%u", std::max(1, std::min(roomCount, static_cast<int>(RoomServer::MAX_ROOMS))),
+        static_cast<unsigned>(port));
+    server.run();
+    activeServer = nullptr;
+
+    Logger::instance().shutdown();
+    return 0;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "spectator.h"
+#include "vec_env.h"
+
+#ifdef _WIN32
+typedef uintptr_t socket_t; // SOCKET, without pulling <winsock2.h> into every includer
+#else
+typedef int socket_t;
+#endif
+
+// Headless TCP server hosting many project04 rooms at once.
+// Every room is one game of a VectorEnv, so the rules are the same as the batched environment
+// (and Game): one I/O thread waits on all sockets (epoll on Linux, WSAPoll on Windows), queues
+// the moves that arrived, then applies them in a single VectorEnv::step over just those rooms,
+// which its worker pool splits up when a tick brings in enough of them. Each applied move is
+// answered with a delta of the cells it changed.
+//
+// Messages are little-endian and fixed-size per type, so no length prefix is needed.
+// Client to server:
+//   JOIN  [0x01][room u16]              takes the first free seat, or watches if both are taken
+//   MOVE  [0x02][room u16][action u8]   action as in VectorEnv::decodeAction
+//   SUBSCRIBE [0x03]                    follow every room through the spectator feed (spectator.h)
+// Server to client:
+//   STATE [0x81][room u16][seat u8][currentPlayer u8][movesLeft u8][p1 i32][p2 i32][board 24 bytes]
+//         seat is 0 or 1, or SPECTATOR; the board is packed with BoardCodec
+//   DELTA [0x82][room u16][flags u8][cleared u16][changed u64][changed cells, 3 bits each]
+//         sent to everyone in the room after a move; flags hold the player who moved (bit 0),
+//         whether the game finished and restarted (bit 1) and whether it was won (bit 2).
+//         Bit i of changed is set for every cell (row * 8 + col) whose gem differs.
+//   REJECT [0x83][room u16][reason u8]
+//   plus, after SUBSCRIBE, a keyframe of every room and then the feed of every move
+class RoomServer {
+public:
+    static const uint8_t MSG_JOIN = 0x01;
+    static const uint8_t MSG_MOVE = 0x02;
+    static const uint8_t MSG_SUBSCRIBE = 0x03;
+    static const uint8_t MSG_STATE = 0x81;
+    static const uint8_t MSG_DELTA = 0x82;
+    static const uint8_t MSG_REJECT = 0x83;
+
+    enum RejectReason : uint8_t { BAD_ROOM = 1, ROOM_FULL, NOT_SEATED, NOT_YOUR_TURN, ILLEGAL_MOVE, MOVE_PENDING };
+
+    static const uint8_t SPECTATOR = 0xFF;
+    static const uint8_t FLAG_PLAYER_2 = 0x01;
+    static const uint8_t FLAG_FINISHED = 0x02;
+    static const uint8_t FLAG_WON = 0x04;
+
+    static const int MAX_ROOMS = 65536; // Room ids are 16 bits
+    static const int MAX_SPECTATORS = 64; // Per room
+
+    // threadCount 0 uses every hardware thread for the rules
+    RoomServer(int roomCount, int threadCount, uint32_t seed);
+    ~RoomServer();
+    RoomServer(const RoomServer&) = delete;
+    RoomServer& operator=(const RoomServer&) = delete;
+
+    // Binds to localhost:port; returns false with a message on stderr if it fails
+    bool listen(uint16_t port);
+
+    // Serves until stop() is called, logging throughput and move latency every few seconds
+    void run();
+
+    // Can be called from any thread or a signal handler
+    void stop() { running.store(false); }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Connection {
+        socket_t sock;
+        bool open;
+        bool wantsWrite; // Registered for write readiness because send() could not take everything
+        bool dirty; // Has output queued this tick
+        bool subscribed; // Receives the spectator feed
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        size_t outputSent;
+        std::vector<int> rooms; // Rooms where this connection has a seat or watches
+    };
+
+    struct Room {
+        int seats[2]; // Connection ids, -1 when free
+        std::vector<int> spectators;
+    };
+
+    VectorEnv env;
+    std::vector<uint8_t> boards; // Observation buffer of env, 64 cells per room
+    std::vector<uint8_t> previousBoards; // Copy of each moved room's board taken before the step
+    std::vector<Room> rooms;
+    std::vector<int32_t> actions; // -1 for rooms without a queued move
+    std::vector<float> rewards;
+    std::vector<uint8_t> dones;
+    std::vector<int32_t> movedRooms; // Rooms with a queued move, in arrival order
+    std::vector<Clock::time_point> moveArrival; // Per room, when its queued move was read
+    FeedEncoder feedEncoder;
+    std::vector<uint8_t> feed; // Feed messages produced this tick
+    std::vector<int> feedSubscribers;
+
+    std::vector<Connection> connections;
+    std::vector<int> freeConnections;
+    std::vector<int> dirtyConnections;
+
+    socket_t listener;
+    std::atomic<bool> running;
+
+    // Move latency histogram for the current stats interval, from read to reply
+    static const int LATENCY_BUCKET_US = 10;
+    static const int LATENCY_BUCKETS = 1000;
+    std::vector<uint32_t> latencyHistogram;
+    uint64_t movesThisInterval;
+
+    class Poller; // Wraps epoll or WSAPoll
+    std::unique_ptr<Poller> poller;
+
+    void acceptConnections();
+    void readConnection(int id);
+    void flushConnection(int id);
+    void closeConnection(int id);
+    bool handleMessages(int id); // Returns false on a malformed message
+    void handleJoin(int id, int room);
+    void handleMove(int id, int room, int action, Clock::time_point arrival);
+    void handleSubscribe(int id);
+    void applyQueuedMoves();
+    void sendState(int id, int room, uint8_t seat);
+    void sendReject(int id, int room, uint8_t reason);
+    void queueOutput(int id, const uint8_t* data, size_t size);
+    void recordLatency(Clock::time_point arrival, Clock::time_point now);
+    void logStats(double seconds);
+};
+
+// Entry point for "project04 --server [port] [rooms] [threads]"
+int runServer(int argc, char* argv[]);
@@ -0,0 +1,108 @@
+// snapshot.cpp
+
+#include "snapshot.h"
+#include "logger.h"
+#include <cstddef>
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    uint32_t checksumOf(const GameSnapshot& snapshot) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&snapshot);
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < offsetof(GameSnapshot, checksum); ++i) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        return hash;
+    }
+}
+
+bool readSnapshotFile(const std::string& path, GameSnapshot& snapshot) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    size_t read = std::fread(&snapshot, sizeof(snapshot), 1, file);
+    std::fclose(file);
+
+    return read == 1 && snapshot.magic == GameSnapshot::MAGIC && snapshot.version == GameSnapshot::VERSION &&
+        snapshot.checksum == checksumOf(snapshot);
+}
+
+SnapshotWriter::SnapshotWriter(const std::string& path) : path(path), pending(), hasPending(false), stopping(false) {
+    worker = std::thread(&SnapshotWriter::writerLoop, this);
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    stop();
+}
+
+void SnapshotWriter::save(const GameSnapshot& snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) return;
+        pending = snapshot; // Replaces a snapshot that has not been written yet
+        hasPending = true;
+    }
+    wake.notify_one();
+}
+
+void SnapshotWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void SnapshotWriter::writerLoop() {
+    while (true) {
+        GameSnapshot snapshot;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return hasPending || stopping; });
+            if (!hasPending) return; // Stopping with nothing left to write
+            snapshot = pending;
+            hasPending = false;
+        }
+        if (!writeFile(snapshot)) {
+            LOG_WARN("Failed to write snapshot to %s", path.c_str());
+        }
+    }
+}
+
+bool SnapshotWriter::writeFile(const GameSnapshot& snapshot) {
+    GameSnapshot stamped = snapshot;
+    stamped.checksum = checksumOf(stamped);
+
+    std::string temporary = path + ".tmp";
+    FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) return false;
+    bool written = std::fwrite(&stamped, sizeof(stamped), 1, file) == 1 && std::fflush(file) == 0;
+    // Reach the disk before the rename, or a crash could leave the new name on an empty file
+#ifdef _WIN32
+    written = written && _commit(_fileno(file)) == 0;
+#else
+    written = written && fsync(fileno(file)) == 0;
+#endif
+    written = std::fclose(file) == 0 && written;
+    if (!written) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    return MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(temporary.c_str(), path.c_str()) == 0; // Atomically replaces the old file
+#endif
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+// One tween of an animation in flight; same fields as Tween with the cell indices narrowed
+struct SnapshotTween {
+    int8_t row;
+    int8_t col;
+    uint8_t easing; // Easing
+    uint8_t reserved;
+    float fromRow, fromCol;
+    float toRow, toCol;
+    float startTime;
+    float duration;
+};
+
+// The whole state of a project04 match in a fixed binary layout, so saving and restoring are
+// plain copies with no parsing. Game::saveSnapshot / Game::restoreSnapshot fill and apply it;
+// a copy in memory serves as a checkpoint for replays and search, and SnapshotWriter puts one
+// on disk. Fields are little-endian as laid out here (every supported target is).
+struct GameSnapshot {
+    static const uint32_t MAGIC = 0x53533447; // "G4SS"
+    static const uint32_t VERSION = 1;
+    static const int MAX_TWEENS = 64; // Game::GRID_SIZE squared, the timeline's capacity
+
+    uint32_t magic;
+    uint32_t version;
+    uint8_t board[64]; // Game::GemType per cell, row by row
+    int32_t player1Score;
+    int32_t player2Score;
+    int32_t movesLeft;
+    uint8_t currentPlayer; // Game::Player
+    uint8_t status; // Game::GameStatus
+    uint8_t phase; // Game::Phase: idle, swapping or falling
+    uint8_t tweenCount;
+    int8_t selectedRow;
+    int8_t selectedCol;
+    int8_t swapR1, swapC1, swapR2, swapC2; // Swap in progress
+    uint8_t cascadeDepth; // Game's count of matches cleared this turn, which scoring depends on
+    uint8_t reserved;
+    float timelineTime;
+    SnapshotTween tweens[MAX_TWEENS];
+    uint32_t checksum; // FNV-1a of every byte before it; only set and checked for files
+};
+
+static_assert(std::is_trivially_copyable<GameSnapshot>::value, "GameSnapshot must stay a plain copyable struct");
+static_assert(sizeof(GameSnapshot) == 104 + 28 * GameSnapshot::MAX_TWEENS, "GameSnapshot layout changed; bump VERSION");
+
+// Reads a snapshot written by SnapshotWriter. Returns false if the file is missing, short,
+// from another version or fails its checksum.
+bool readSnapshotFile(const std::string& path, GameSnapshot& snapshot);
+
+// Writes snapshots to a file on a background thread so the caller never waits on the disk.
+// Each write goes to path + ".tmp" and is renamed over path once complete, so a crash leaves
+// either the previous snapshot or the new one. If saves come in faster than the disk keeps up,
+// only the newest pending one is written.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(const std::string& path);
+    ~SnapshotWriter(); // Calls stop()
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    void save(const GameSnapshot& snapshot);
+
+    // Finishes the pending write and joins the thread. Saves after this are ignored.
+    void stop();
+
+private:
+    std::string path;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    GameSnapshot pending;
+    bool hasPending;
+    bool stopping;
+
+    void writerLoop();
+    bool writeFile(const GameSnapshot& snapshot);
+};
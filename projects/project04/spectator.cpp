@@ -0,0 +1,304 @@
+// spectator.cpp
+
+#include "spectator.h"
+#include "../common/board_codec.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace SpectatorFeed;
+
+namespace {
+    const int N = VectorEnv::GRID_SIZE;
+    const int CELLS = VectorEnv::CELLS;
+    const size_t TURN_HEADER_SIZE = 6;
+
+    int popCount(uint64_t bits) {
+        int count = 0;
+        for (; bits; bits &= bits - 1) count++;
+        return count;
+    }
+
+    void writeU16(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void writeU32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    uint32_t readU16(const uint8_t* in) {
+        return in[0] | (static_cast<uint32_t>(in[1]) << 8);
+    }
+
+    uint32_t readU32(const uint8_t* in) {
+        return in[0] | (static_cast<uint32_t>(in[1]) << 8) | (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+    }
+
+    void writeSparseMask(std::vector<uint8_t>& out, uint64_t mask) {
+        size_t mapPos = out.size();
+        out.push_back(0);
+        for (int i = 0; i < 8; ++i) {
+            uint8_t byte = static_cast<uint8_t>(mask >> (8 * i));
+            if (byte) {
+                out[mapPos] |= static_cast<uint8_t>(1 << i);
+                out.push_back(byte);
+            }
+        }
+    }
+
+    // Returns the bytes the mask took, or 0 if data ends first
+    size_t readSparseMask(const uint8_t* data, size_t size, uint64_t& mask) {
+        if (size < 1) return 0;
+        size_t length = 1 + popCount(data[0]);
+        if (size < length) return 0;
+        mask = 0;
+        size_t pos = 1;
+        for (int i = 0; i < 8; ++i) {
+            if (data[0] & (1 << i)) mask |= static_cast<uint64_t>(data[pos++]) << (8 * i);
+        }
+        return length;
+    }
+
+    // Same gravity and refill order as Match3::Rules::drop and refill, taking the new gems from the
+    // packed refill stream instead of the random generator
+    void replayCascade(uint8_t* board, uint64_t cleared, const uint8_t* refills, size_t& refillIndex) {
+        for (int i = 0; i < CELLS; ++i) {
+            if (cleared & (uint64_t(1) << i)) board[i] = 0;
+        }
+        const uint64_t COLUMN = 0x0101010101010101ull; // Column 0 of the mask
+        for (int c = 0; c < N; ++c) {
+            if (!(cleared & (COLUMN << c))) continue; // Untouched columns keep their gems and take no refills
+            int writeRow = N - 1;
+            for (int r = N - 1; r >= 0; --r) {
+                if (board[r * N + c] != 0) {
+                    board[writeRow * N + c] = board[r * N + c];
+                    writeRow--;
+                }
+            }
+            for (int r = writeRow; r >= 0; --r) {
+                board[r * N + c] = static_cast<uint8_t>(BoardCodec::getCell(refills, refillIndex++));
+            }
+        }
+    }
+}
+
+FeedEncoder::FeedEncoder(int gameCount) : turnsSinceKeyframe(gameCount, 0) {
+}
+
+void FeedEncoder::keyframe(const VectorEnv& env, int game, std::vector<uint8_t>& out) {
+    out.push_back(MSG_KEYFRAME);
+    writeU16(out, static_cast<uint32_t>(game));
+    out.push_back(env.currentPlayers()[game]);
+    out.push_back(static_cast<uint8_t>(env.movesLeft()[game]));
+    writeU32(out, static_cast<uint32_t>(env.player1Scores()[game]));
+    writeU32(out, static_cast<uint32_t>(env.player2Scores()[game]));
+    size_t boardPos = out.size();
+    out.resize(boardPos + BoardCodec::packedSize(N, N));
+    const uint8_t (*board)[N] = reinterpret_cast<const uint8_t (*)[N]>(env.board(game));
+    BoardCodec::pack(board, N, N, &out[boardPos]);
+    turnsSinceKeyframe[game] = 0;
+}
+
+void FeedEncoder::turn(const VectorEnv& env, int game, int action, uint8_t done, std::vector<uint8_t>& out) {
+    int cascades = env.cascadeCount(game);
+    if (cascades == 0) return; // Action was ignored, nothing changed
+
+    if (cascades <= 255) {
+        uint8_t flags = 0;
+        if (done) {
+            flags |= FLAG_FINISHED;
+            if (env.lastOutcomes()[game] == VectorEnv::WIN) flags |= FLAG_WON;
+        }
+        out.push_back(MSG_TURN);
+        writeU16(out, static_cast<uint32_t>(game));
+        out.push_back(static_cast<uint8_t>(action));
+        out.push_back(flags);
+        out.push_back(static_cast<uint8_t>(cascades));
+        for (int i = 0; i < cascades; ++i) {
+            writeSparseMask(out, env.clearedMask(game, i));
+        }
+
+        const std::vector<uint8_t>& refills = env.refillGems(game);
+        size_t refillPos = out.size();
+        out.resize(refillPos + (refills.size() * BoardCodec::BITS_PER_CELL + 7) / 8, 0);
+        for (size_t i = 0; i < refills.size(); ++i) {
+            BoardCodec::setCell(&out[refillPos], i, refills[i]);
+        }
+    }
+    // A turn with more cascades than the header can count is sent as a keyframe alone
+
+    if (done || cascades > 255 || ++turnsSinceKeyframe[game] >= KEYFRAME_INTERVAL) {
+        keyframe(env, game, out); // After a finished game this is the fresh board step() dealt
+    }
+}
+
+FeedDecoder::FeedDecoder() {
+}
+
+FeedDecoder::GameView& FeedDecoder::view(int id) {
+    if (id >= static_cast<int>(games.size())) {
+        GameView empty = {};
+        games.resize(id + 1, empty);
+    }
+    return games[id];
+}
+
+bool FeedDecoder::decode(const uint8_t* data, size_t size, size_t& used) {
+    size_t pos = 0;
+    while (pos < size) {
+        const uint8_t* message = data + pos;
+        size_t available = size - pos;
+
+        if (message[0] == MSG_KEYFRAME) {
+            if (available < KEYFRAME_SIZE) break;
+            GameView& game = view(static_cast<int>(readU16(message + 1)));
+            game.synced = true;
+            game.currentPlayer = message[3];
+            game.movesLeft = message[4];
+            game.player1Score = static_cast<int32_t>(readU32(message + 5));
+            game.player2Score = static_cast<int32_t>(readU32(message + 9));
+            for (int i = 0; i < CELLS; ++i) {
+                game.board[i] = static_cast<uint8_t>(BoardCodec::getCell(message + 13, i));
+            }
+            pos += KEYFRAME_SIZE;
+        }
+        else if (message[0] == MSG_TURN) {
+            if (available < TURN_HEADER_SIZE) break;
+            int action = message[3];
+            int cascades = message[5];
+            if (action >= VectorEnv::ACTION_COUNT || cascades == 0) {
+                used = pos;
+                return false;
+            }
+
+            // Find the end of the message before touching the game
+            uint64_t masks[255];
+            size_t length = TURN_HEADER_SIZE;
+            int cleared = 0;
+            bool complete = true;
+            for (int i = 0; i < cascades; ++i) {
+                size_t maskLength = readSparseMask(message + length, available - length, masks[i]);
+                if (maskLength == 0) {
+                    complete = false;
+                    break;
+                }
+                length += maskLength;
+                cleared += popCount(masks[i]);
+            }
+            size_t refillLength = (static_cast<size_t>(cleared) * BoardCodec::BITS_PER_CELL + 7) / 8;
+            if (!complete || available < length + refillLength) break;
+
+            GameView& game = view(static_cast<int>(readU16(message + 1)));
+            if (game.synced) {
+                int r1, c1, r2, c2;
+                VectorEnv::decodeAction(action, r1, c1, r2, c2);
+                std::swap(game.board[r1 * N + c1], game.board[r2 * N + c2]);
+                size_t refillIndex = 0;
+                for (int i = 0; i < cascades; ++i) {
+                    replayCascade(game.board, masks[i], message + length, refillIndex);
+                }
+
+                // Same bookkeeping as VectorEnv::stepOne
+                int32_t points = cleared * VectorEnv::POINTS_PER_GEM;
+                if (game.currentPlayer == 0) {
+                    game.player1Score += points;
+                }
+                else {
+                    game.player2Score += points;
+                }
+                game.movesLeft--;
+                game.lastFlags = message[4];
+                if (!(game.lastFlags & FLAG_FINISHED)) game.currentPlayer ^= 1;
+            }
+            pos += length + refillLength;
+        }
+        else {
+            used = pos;
+            return false;
+        }
+    }
+    used = pos;
+    return true;
+}
+
+int runFeedBenchmark(int argc, char* argv[]) {
+    typedef std::chrono::steady_clock Clock;
+    int gameCount = argc > 2 ? std::atoi(argv[2]) : 4096;
+    int turns = argc > 3 ? std::atoi(argv[3]) : 200;
+    gameCount = std::max(1, std::min(gameCount, MAX_GAMES));
+
+    VectorEnv env;
+    std::vector<uint8_t> boards(static_cast<size_t>(gameCount) * CELLS);
+    env.setRecordCascades(true);
+    env.reset(gameCount, boards.data(), 2024u);
+
+    FeedEncoder encoder(gameCount);
+    FeedDecoder decoder;
+    std::vector<uint8_t> feed;
+    for (int game = 0; game < gameCount; ++game) {
+        encoder.keyframe(env, game, feed);
+    }
+    size_t used;
+    decoder.decode(feed.data(), feed.size(), used);
+
+    std::vector<int32_t> actions(gameCount);
+    std::vector<float> rewards(gameCount);
+    std::vector<uint8_t> dones(gameCount);
+    uint32_t rng = 7;
+    double encodeSeconds = 0.0;
+    double decodeSeconds = 0.0;
+    uint64_t feedBytes = 0;
+    uint64_t turnCount = 0;
+
+    for (int t = 0; t < turns; ++t) {
+        // Random legal move for every game (a board always has one, or step() would have reset it)
+        for (int game = 0; game < gameCount; ++game) {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            int action = static_cast<int>(rng % VectorEnv::ACTION_COUNT);
+            while (!env.isLegal(game, action)) action = (action + 1) % VectorEnv::ACTION_COUNT;
+            actions[game] = action;
+        }
+        env.step(actions.data(), rewards.data(), dones.data());
+
+        feed.clear();
+        Clock::time_point start = Clock::now();
+        for (int game = 0; game < gameCount; ++game) {
+            encoder.turn(env, game, actions[game], dones[game], feed);
+        }
+        Clock::time_point encoded = Clock::now();
+        bool valid = decoder.decode(feed.data(), feed.size(), used);
+        Clock::time_point decoded = Clock::now();
+        encodeSeconds += std::chrono::duration<double>(encoded - start).count();
+        decodeSeconds += std::chrono::duration<double>(decoded - encoded).count();
+        feedBytes += feed.size();
+        turnCount += gameCount;
+
+        if (!valid || used != feed.size()) {
+            std::printf("Feed could not be decoded after turn %d\n", t);
+            return 1;
+        }
+        for (int game = 0; game < gameCount; ++game) {
+            const FeedDecoder::GameView& view = decoder.game(game);
+            if (std::memcmp(view.board, env.board(game), CELLS) != 0 ||
+                view.player1Score != env.player1Scores()[game] || view.player2Score != env.player2Scores()[game] ||
+                view.movesLeft != env.movesLeft()[game] || view.currentPlayer != env.currentPlayers()[game]) {
+                std::printf("Game %d diverged after turn %d\n", game, t);
+                return 1;
+            }
+        }
+    }
+
+    std::printf("%d games, %llu turns, every board reconstructed exactly\n", gameCount,
+        static_cast<unsigned long long>(turnCount));
+    std::printf("Feed: %.1f bytes per turn including keyframes (full board: %d bytes, packed: %zu bytes)\n",
+        static_cast<double>(feedBytes) / turnCount, CELLS, KEYFRAME_SIZE);
+    std::printf("Encode: %.2f M turns/s (%.0f MB/s)\n", turnCount / encodeSeconds / 1e6, feedBytes / encodeSeconds / 1e6);
+    std::printf("Decode: %.2f M turns/s (%.0f MB/s)\n", turnCount / decodeSeconds / 1e6, feedBytes / decodeSeconds / 1e6);
+    return 0;
+}
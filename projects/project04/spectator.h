@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "vec_env.h"
+
+// Compact feed that lets spectators follow many VectorEnv games and rebuild their exact boards.
+// Instead of whole boards, each turn carries the swap, the cells every cascade cleared and the
+// gems that refilled them; the decoder replays that with the same gravity as the rules. A
+// keyframe with the full state starts every game, follows every finished game and is repeated
+// every KEYFRAME_INTERVAL turns, so a subscriber can join mid-stream.
+//
+// Messages are little-endian and never start with a byte the room server uses for anything else:
+//   KEYFRAME [0x84][game u16][currentPlayer u8][movesLeft u8][p1 i32][p2 i32][board 24 bytes]
+//   TURN     [0x85][game u16][action u8][flags u8][cascades u8]
+//            then a sparse mask per cascade and the refill gems, 3 bits each, packed like
+//            BoardCodec. A sparse mask is a byte with bit i set when byte i of the 64-bit cleared
+//            mask is non-zero, followed by those bytes: a cleared row of three takes 2 bytes.
+//            flags: FLAG_FINISHED when the turn ended the game, FLAG_WON when it was won.
+namespace SpectatorFeed {
+    const uint8_t MSG_KEYFRAME = 0x84;
+    const uint8_t MSG_TURN = 0x85;
+    const uint8_t FLAG_FINISHED = 0x01;
+    const uint8_t FLAG_WON = 0x02;
+    const int KEYFRAME_INTERVAL = 32; // Turns per game between keyframes
+    const size_t KEYFRAME_SIZE = 13 + 24;
+    const int MAX_GAMES = 65536; // Game ids are 16 bits
+}
+
+class FeedEncoder {
+public:
+    explicit FeedEncoder(int gameCount);
+
+    // Appends the full state of game to out
+    void keyframe(const VectorEnv& env, int game, std::vector<uint8_t>& out);
+
+    // Appends the turn game just played in env.step, which must have had cascade recording on.
+    // done is the game's done flag from that step. Ignored actions append nothing.
+    void turn(const VectorEnv& env, int game, int action, uint8_t done, std::vector<uint8_t>& out);
+
+private:
+    std::vector<uint16_t> turnsSinceKeyframe;
+};
+
+class FeedDecoder {
+public:
+    struct GameView {
+        bool synced; // False until the first keyframe for this game arrives
+        uint8_t board[VectorEnv::CELLS]; // Same cell values as VectorEnv
+        int32_t player1Score;
+        int32_t player2Score;
+        int movesLeft;
+        int currentPlayer;
+        uint8_t lastFlags; // Flags of the last turn, so a viewer can show how a game ended
+    };
+
+    FeedDecoder();
+
+    // Applies every complete message in data and sets used to the bytes consumed; a trailing
+    // partial message is left for the next call. Returns false if the data is not a feed.
+    bool decode(const uint8_t* data, size_t size, size_t& used);
+
+    int gameCount() const { return static_cast<int>(games.size()); }
+    const GameView& game(int id) const { return games[id]; }
+
+private:
+    std::vector<GameView> games; // Grows to the highest game id seen
+    GameView& view(int id);
+};
+
+// Entry point for "project04 --feed-bench [games] [turns]": plays random legal moves in a
+// VectorEnv, encodes and decodes the feed, checks every reconstructed board and prints throughput
+int runFeedBenchmark(int argc, char* argv[]);
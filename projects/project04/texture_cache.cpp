@@ -0,0 +1,188 @@
+#include "texture_cache.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <cmath>
+#include "logger.h"
+
+namespace {
+    // One source pixel and the share of a destination pixel it covers
+    struct Tap {
+        int index;
+        float weight;
+    };
+
+    // The source pixels, with their coverage, that average into each of count destination pixels
+    std::vector<std::vector<Tap>> boxTaps(int sourceSize, int count) {
+        std::vector<std::vector<Tap>> taps(count);
+        float step = static_cast<float>(sourceSize) / count;
+        for (int i = 0; i < count; ++i) {
+            float begin = i * step;
+            float end = begin + step;
+            for (int s = static_cast<int>(begin); s < sourceSize && s < end; ++s) {
+                float weight = (std::min(end, s + 1.0f) - std::max(begin, static_cast<float>(s))) / step;
+                if (weight > 0.0f) taps[i].push_back({ s, weight });
+            }
+        }
+        return taps;
+    }
+}
+
+TextureCache::TextureCache(SDL_Renderer* renderer, int logicalWidth, int logicalHeight)
+    : renderer(renderer), logicalWidth(logicalWidth), logicalHeight(logicalHeight), scale(1.0f) {
+    updateScale();
+}
+
+TextureCache::~TextureCache() {
+    destroy();
+}
+
+int TextureCache::load(const std::string& path) {
+    SDL_Surface* file = IMG_Load(path.c_str());
+    if (!file) {
+        LOG_ERROR("Error loading texture '%s': %s", path.c_str(), IMG_GetError());
+        return -1;
+    }
+    SDL_Surface* source = SDL_ConvertSurfaceFormat(file, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(file);
+    if (!source) {
+        LOG_ERROR("Error converting texture '%s': %s", path.c_str(), SDL_GetError());
+        return -1;
+    }
+
+    Image image;
+    image.levels.push_back(source);
+    while (image.levels.back()->w >= 2 && image.levels.back()->h >= 2) {
+        SDL_Surface* level = image.levels.back();
+        SDL_Surface* half = downscale(level, level->w / 2, level->h / 2);
+        if (!half) break;
+        image.levels.push_back(half);
+    }
+    images.push_back(image);
+    return static_cast<int>(images.size()) - 1;
+}
+
+SDL_Texture* TextureCache::get(int image, int width, int height) {
+    if (image < 0 || image >= static_cast<int>(images.size())) return nullptr;
+    Image& entry = images[image];
+    for (const Scaled& scaled : entry.scaled) {
+        if (scaled.width == width && scaled.height == height) return scaled.texture;
+    }
+
+    int pixelWidth = std::max(1, static_cast<int>(std::lround(width * scale)));
+    int pixelHeight = std::max(1, static_cast<int>(std::lround(height * scale)));
+    size_t level = 0;
+    while (level + 1 < entry.levels.size() && entry.levels[level + 1]->w >= pixelWidth && entry.levels[level + 1]->h >= pixelHeight) {
+        ++level;
+    }
+    SDL_Surface* source = entry.levels[level];
+    bool shrinks = source->w >= pixelWidth && source->h >= pixelHeight &&
+        (source->w != pixelWidth || source->h != pixelHeight);
+    SDL_Surface* fitted = shrinks ? downscale(source, pixelWidth, pixelHeight) : nullptr;
+
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, fitted ? fitted : source);
+    if (fitted) SDL_FreeSurface(fitted);
+    if (!texture) {
+        LOG_WARN("Failed to create a %dx%d texture: %s", pixelWidth, pixelHeight, SDL_GetError());
+        return nullptr;
+    }
+    SDL_SetTextureScaleMode(texture, SDL_ScaleModeLinear); // Only used when the renderer still stretches it
+    entry.scaled.push_back({ width, height, texture });
+    return texture;
+}
+
+void TextureCache::handleEvent(const SDL_Event& event) {
+    if (event.type == SDL_WINDOWEVENT && (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+        event.window.event == SDL_WINDOWEVENT_DISPLAY_CHANGED)) {
+        updateScale();
+    }
+    else if (event.type == SDL_RENDER_DEVICE_RESET) {
+        freeTextures(); // Their contents are gone, but SDL keeps the texture objects until destroyed
+    }
+}
+
+void TextureCache::destroy() {
+    freeTextures();
+    for (Image& image : images) {
+        for (SDL_Surface* level : image.levels) {
+            SDL_FreeSurface(level);
+        }
+    }
+    images.clear();
+}
+
+// Letterboxed like SDL_RenderSetLogicalSize: the smaller of the two axis scales
+void TextureCache::updateScale() {
+    int outputWidth = logicalWidth;
+    int outputHeight = logicalHeight;
+    SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight);
+    float newScale = std::min(static_cast<float>(outputWidth) / logicalWidth, static_cast<float>(outputHeight) / logicalHeight);
+    if (newScale <= 0.0f || newScale == scale) return;
+
+    scale = newScale;
+    freeTextures();
+}
+
+void TextureCache::freeTextures() {
+    for (Image& image : images) {
+        for (const Scaled& scaled : image.scaled) {
+            SDL_DestroyTexture(scaled.texture);
+        }
+        image.scaled.clear();
+    }
+}
+
+// Area-averaged resize to a smaller size. Colors are weighted by alpha so the transparent
+// pixels around a gem do not darken its edge.
+SDL_Surface* TextureCache::downscale(SDL_Surface* source, int width, int height) {
+    SDL_Surface* result = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!result) return nullptr;
+    std::vector<std::vector<Tap>> columns = boxTaps(source->w, width);
+    std::vector<std::vector<Tap>> rows = boxTaps(source->h, height);
+
+    // Horizontal pass into premultiplied floats, one row of the source at a time
+    std::vector<float> wide(static_cast<size_t>(width) * source->h * 4);
+    SDL_LockSurface(source);
+    for (int y = 0; y < source->h; ++y) {
+        const Uint32* in = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(source->pixels) + y * source->pitch);
+        float* out = &wide[static_cast<size_t>(y) * width * 4];
+        for (int x = 0; x < width; ++x) {
+            float a = 0.0f, r = 0.0f, g = 0.0f, b = 0.0f;
+            for (const Tap& tap : columns[x]) {
+                Uint32 pixel = in[tap.index];
+                float alpha = (pixel >> 24) * tap.weight;
+                a += alpha;
+                r += ((pixel >> 16) & 0xFF) * alpha;
+                g += ((pixel >> 8) & 0xFF) * alpha;
+                b += (pixel & 0xFF) * alpha;
+            }
+            out[x * 4 + 0] = a;
+            out[x * 4 + 1] = r;
+            out[x * 4 + 2] = g;
+            out[x * 4 + 3] = b;
+        }
+    }
+    SDL_UnlockSurface(source);
+
+    SDL_LockSurface(result);
+    for (int y = 0; y < height; ++y) {
+        Uint32* out = reinterpret_cast<Uint32*>(static_cast<Uint8*>(result->pixels) + y * result->pitch);
+        for (int x = 0; x < width; ++x) {
+            float a = 0.0f, r = 0.0f, g = 0.0f, b = 0.0f;
+            for (const Tap& tap : rows[y]) {
+                const float* in = &wide[(static_cast<size_t>(tap.index) * width + x) * 4];
+                a += in[0] * tap.weight;
+                r += in[1] * tap.weight;
+                g += in[2] * tap.weight;
+                b += in[3] * tap.weight;
+            }
+            float unpremultiply = a > 0.0f ? 1.0f / a : 0.0f;
+            Uint32 alpha = static_cast<Uint32>(std::min(255.0f, a + 0.5f));
+            Uint32 red = static_cast<Uint32>(std::min(255.0f, r * unpremultiply + 0.5f));
+            Uint32 green = static_cast<Uint32>(std::min(255.0f, g * unpremultiply + 0.5f));
+            Uint32 blue = static_cast<Uint32>(std::min(255.0f, b * unpremultiply + 0.5f));
+            out[x] = (alpha << 24) | (red << 16) | (green << 8) | blue;
+        }
+    }
+    SDL_UnlockSurface(result);
+    return result;
+}
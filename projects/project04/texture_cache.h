@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+// Images kept in memory with a mipmap chain, handed to the renderer as textures already scaled
+// to the size they are drawn at. The GPU then copies each texture pixel for pixel instead of
+// filtering a 1024 px source down to a 64 px gem every frame.
+//
+// Sizes are asked for in logical pixels (the 800x700 layout); the cache turns them into output
+// pixels with the renderer's current scale, so a HiDPI display or a larger window gets sharper
+// textures. Each requested size is made once, from the smallest mip level that still covers it,
+// and kept until the scale changes.
+class TextureCache {
+public:
+    TextureCache(SDL_Renderer* renderer, int logicalWidth, int logicalHeight);
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // Reads an image and builds its mipmap chain. Returns its id, or -1 if it cannot be read.
+    int load(const std::string& path);
+
+    // The image pre-scaled for drawing at width x height logical pixels, made on first use.
+    // Sizes larger than the image are left to the renderer to stretch. Null if it cannot be made.
+    SDL_Texture* get(int image, int width, int height);
+
+    // Call on window and render events: a resize or a move to another display rescales
+    // everything, and a lost device drops every texture.
+    void handleEvent(const SDL_Event& event);
+
+    // Frees every texture and image; call before destroying the renderer, which would
+    // otherwise free the textures first
+    void destroy();
+
+private:
+    struct Scaled {
+        int width; // Logical size it was asked for
+        int height;
+        SDL_Texture* texture;
+    };
+
+    struct Image {
+        std::vector<SDL_Surface*> levels; // ARGB8888; level 0 is the file, each next one half the size
+        std::vector<Scaled> scaled;
+    };
+
+    SDL_Renderer* renderer;
+    int logicalWidth;
+    int logicalHeight;
+    float scale; // Output pixels per logical pixel
+    std::vector<Image> images;
+
+    void updateScale();
+    void freeTextures();
+    static SDL_Surface* downscale(SDL_Surface* source, int width, int height);
+};
@@ -0,0 +1,50 @@
+// timeline.cpp
+
+#include "timeline.h"
+
+Timeline::Timeline(int capacity) : capacity(capacity), time(0.0f) {
+    tweens.reserve(capacity);
+}
+
+void Timeline::clear(float startTime) {
+    tweens.clear();
+    time = startTime;
+}
+
+bool Timeline::add(const Tween& tween) {
+    if (static_cast<int>(tweens.size()) >= capacity) {
+        return false;
+    }
+    tweens.push_back(tween);
+    return true;
+}
+
+void Timeline::advance(float deltaTime) {
+    time += deltaTime;
+    for (int i = 0; i < static_cast<int>(tweens.size());) {
+        if (time >= tweens[i].startTime + tweens[i].duration) {
+            tweens[i] = tweens.back(); // Order does not matter, so fill the hole with the last tween
+            tweens.pop_back();
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+void Timeline::sample(const Tween& tween, float& row, float& col) const {
+    float t = tween.duration > 0.0f ? (time - tween.startTime) / tween.duration : 1.0f;
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    float k = ease(tween.easing, t);
+    row = tween.fromRow + (tween.toRow - tween.fromRow) * k;
+    col = tween.fromCol + (tween.toCol - tween.fromCol) * k;
+}
+
+float Timeline::ease(Easing easing, float t) {
+    switch (easing) {
+    case Easing::EASE_IN_QUAD: return t * t; // Speeds up, like falling
+    case Easing::EASE_OUT_QUAD: return t * (2.0f - t);
+    default: return t;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+// Easing curves a tween can follow
+enum class Easing { LINEAR, EASE_IN_QUAD, EASE_OUT_QUAD };
+
+// Moves the gem that now sits in board cell (row, col) from one board position to another.
+// Positions are in cell units (fromRow -1 is one cell above the board), so the renderer
+// decides the pixel layout.
+struct Tween {
+    int row;
+    int col;
+    float fromRow, fromCol;
+    float toRow, toCol;
+    float startTime; // Timeline time the tween begins, later than now() to delay it
+    float duration; // Seconds
+    Easing easing;
+};
+
+// A flat, preallocated pool of active tweens.
+// Finished tweens are removed by swapping with the last one, so nothing allocates after
+// construction as long as no more than capacity tweens run at once.
+class Timeline {
+public:
+    explicit Timeline(int capacity);
+
+    // Removes every tween and restarts the clock at startTime
+    void clear(float startTime = 0.0f);
+
+    // Schedules a tween. Returns false (and drops it) if the pool is full.
+    bool add(const Tween& tween);
+
+    // Moves the clock forward and drops the tweens that have finished
+    void advance(float deltaTime);
+
+    bool isIdle() const { return tweens.empty(); }
+    float now() const { return time; }
+    int size() const { return static_cast<int>(tweens.size()); }
+    const Tween& at(int i) const { return tweens[i]; }
+
+    // Current position of a tween in cell units
+    void sample(const Tween& tween, float& row, float& col) const;
+
+    static float ease(Easing easing, float t);
+
+private:
+    std::vector<Tween> tweens; // Reserved once in the constructor
+    int capacity;
+    float time;
+};
@@ -0,0 +1,500 @@
+// tournament.cpp
+
+#include "tournament.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace {
+    const int CELLS = VectorEnv::CELLS;
+    const int ACTIONS = VectorEnv::ACTION_COUNT;
+
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // splitmix64, used to derive independent seeds from the tournament seed and a game's place
+    uint64_t mixSeed(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    uint32_t rngFromSeed(uint64_t seed) {
+        uint32_t state = static_cast<uint32_t>(mixSeed(seed));
+        return state != 0 ? state : 1; // xorshift must not be 0
+    }
+
+    // Action clearing the most gems right away, ties broken at random; -1 if there is none
+    int greedyAction(const uint8_t* board, uint32_t& rng) {
+        int best = -1;
+        int bestCount = 0;
+        int ties = 0;
+        for (int action = 0; action < ACTIONS; ++action) {
+            int count = VectorEnv::immediateClearCount(board, action);
+            if (count == 0 || count < bestCount) continue;
+            if (count > bestCount) {
+                bestCount = count;
+                ties = 0;
+            }
+            if (nextRandom(rng) % ++ties == 0) best = action; // Each tied action is kept with equal chance
+        }
+        return best;
+    }
+
+    // Any legal action, chosen uniformly enough for playouts; -1 if there is none
+    int randomAction(const uint8_t* board, uint32_t& rng) {
+        int start = static_cast<int>(nextRandom(rng) % ACTIONS);
+        for (int i = 0; i < ACTIONS; ++i) {
+            int action = (start + i) % ACTIONS;
+            if (VectorEnv::isLegalAction(board, action)) return action;
+        }
+        return -1;
+    }
+
+    class GreedyPolicy : public Policy {
+    public:
+        GreedyPolicy() { label = "greedy"; }
+
+        int chooseAction(const BotView& view, uint32_t& rng) const override {
+            return greedyAction(view.board, rng);
+        }
+    };
+
+    // Monte Carlo: every legal action is followed by random playouts with sampled refills, and
+    // the action with the best average point difference over the playouts wins
+    class RolloutPolicy : public Policy {
+    public:
+        RolloutPolicy(int playouts, int plies) : playouts(playouts), plies(plies) {
+            label = "rollout:" + std::to_string(playouts) + ":" + std::to_string(plies);
+        }
+
+        int chooseAction(const BotView& view, uint32_t& rng) const override {
+            int best = -1;
+            double bestValue = 0.0;
+            for (int action = 0; action < ACTIONS; ++action) {
+                if (!VectorEnv::isLegalAction(view.board, action)) continue;
+
+                double total = 0.0;
+                for (int p = 0; p < playouts; ++p) {
+                    uint8_t board[CELLS];
+                    std::memcpy(board, view.board, CELLS);
+                    int difference = VectorEnv::playAction(board, action, rng);
+                    int sign = -1; // Opponent moves next
+                    int movesLeft = view.movesLeft - 1;
+                    for (int ply = 1; ply < plies && movesLeft > 0; ++ply, --movesLeft) {
+                        int reply = randomAction(board, rng);
+                        if (reply < 0) break;
+                        difference += sign * VectorEnv::playAction(board, reply, rng);
+                        sign = -sign;
+                    }
+                    total += difference;
+                }
+
+                if (best < 0 || total > bestValue) {
+                    best = action;
+                    bestValue = total;
+                }
+            }
+            return best;
+        }
+
+    private:
+        int playouts;
+        int plies;
+    };
+
+    // Two plies: a chance node over sampled refills after each of our actions, then the
+    // opponent's best immediate reply on each sampled board
+    class ExpectimaxPolicy : public Policy {
+    public:
+        explicit ExpectimaxPolicy(int samples) : samples(samples) {
+            label = "expectimax:" + std::to_string(samples);
+        }
+
+        int chooseAction(const BotView& view, uint32_t& rng) const override {
+            int best = -1;
+            double bestValue = 0.0;
+            for (int action = 0; action < ACTIONS; ++action) {
+                if (!VectorEnv::isLegalAction(view.board, action)) continue;
+
+                double total = 0.0;
+                for (int s = 0; s < samples; ++s) {
+                    uint8_t board[CELLS];
+                    std::memcpy(board, view.board, CELLS);
+                    int gained = VectorEnv::playAction(board, action, rng);
+                    int reply = 0;
+                    if (view.movesLeft > 1) {
+                        for (int next = 0; next < ACTIONS; ++next) {
+                            reply = std::max(reply, VectorEnv::immediateClearCount(board, next));
+                        }
+                    }
+                    total += gained - reply;
+                }
+
+                if (best < 0 || total > bestValue) {
+                    best = action;
+                    bestValue = total;
+                }
+            }
+            return best;
+        }
+
+    private:
+        int samples;
+    };
+
+    // One game of the project04 rules between two bots. Returns 1 if first wins, 0 if second
+    // wins and 0.5 for a draw; the higher score wins when the game ends, as in the UI.
+    double playGame(const Policy& first, const Policy& second, uint64_t seed) {
+        uint32_t gameRng = rngFromSeed(seed);
+        uint32_t botRng[2] = { rngFromSeed(seed ^ 0xA5A5A5A5ull), rngFromSeed(seed ^ 0x5A5A5A5Aull) };
+        const Policy* players[2] = { &first, &second };
+
+        BotView view;
+        VectorEnv::dealBoard(view.board, gameRng);
+        int32_t scores[2] = { 0, 0 };
+        int movesLeft = VectorEnv::MAX_MOVES;
+        int player = 0;
+
+        while (true) {
+            view.myScore = scores[player];
+            view.opponentScore = scores[player ^ 1];
+            view.movesLeft = movesLeft;
+            int action = players[player]->chooseAction(view, botRng[player]);
+            if (!VectorEnv::isLegalAction(view.board, action)) {
+                action = randomAction(view.board, botRng[player]); // A broken bot forfeits its choice, not the game
+            }
+            scores[player] += VectorEnv::playAction(view.board, action, gameRng) * VectorEnv::POINTS_PER_GEM;
+
+            // Same order of checks as VectorEnv::stepOne
+            movesLeft--;
+            if (scores[0] >= VectorEnv::WIN_SCORE || scores[1] >= VectorEnv::WIN_SCORE ||
+                movesLeft <= 0 || !VectorEnv::hasLegalAction(view.board)) {
+                break;
+            }
+            player ^= 1;
+        }
+
+        if (scores[0] == scores[1]) return 0.5;
+        return scores[0] > scores[1] ? 1.0 : 0.0;
+    }
+
+    struct Pairing {
+        int a;
+        int b;
+    };
+
+    // Plays gamesPerPairing games for every pairing across threads; results[p * games + g] is
+    // entrant a's score in game g of pairing p. Odd games replay the previous seed with seats swapped.
+    void playPairings(const std::vector<const Policy*>& entrants, const std::vector<Pairing>& pairings, int gamesPerPairing,
+        uint64_t roundSeed, int threads, std::vector<double>& results) {
+        size_t total = pairings.size() * gamesPerPairing;
+        results.assign(total, 0.0);
+        std::atomic<size_t> next(0);
+
+        auto worker = [&]() {
+            const size_t CHUNK = 16; // Games claimed at a time
+            while (true) {
+                size_t begin = next.fetch_add(CHUNK);
+                if (begin >= total) return;
+                size_t end = std::min(total, begin + CHUNK);
+                for (size_t job = begin; job < end; ++job) {
+                    size_t pairingIndex = job / gamesPerPairing;
+                    const Pairing& pairing = pairings[pairingIndex];
+                    int game = static_cast<int>(job % gamesPerPairing);
+                    // Every seat-swapped pair of games in the round gets its own index, however
+                    // many games each pairing plays
+                    uint64_t deal = static_cast<uint64_t>(pairingIndex) * static_cast<uint64_t>(gamesPerPairing) + game / 2;
+                    uint64_t seed = mixSeed(roundSeed ^ mixSeed(deal));
+                    if (game % 2 == 0) {
+                        results[job] = playGame(*entrants[pairing.a], *entrants[pairing.b], seed);
+                    }
+                    else {
+                        results[job] = 1.0 - playGame(*entrants[pairing.b], *entrants[pairing.a], seed);
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; ++t) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    // Inverts a small symmetric matrix in place with Gauss-Jordan elimination
+    void invert(std::vector<double>& matrix, int n) {
+        std::vector<double> inverse(n * n, 0.0);
+        for (int i = 0; i < n; ++i) inverse[i * n + i] = 1.0;
+        for (int col = 0; col < n; ++col) {
+            int pivot = col;
+            for (int row = col + 1; row < n; ++row) {
+                if (std::fabs(matrix[row * n + col]) > std::fabs(matrix[pivot * n + col])) pivot = row;
+            }
+            for (int k = 0; k < n; ++k) {
+                std::swap(matrix[col * n + k], matrix[pivot * n + k]);
+                std::swap(inverse[col * n + k], inverse[pivot * n + k]);
+            }
+            double scale = matrix[col * n + col];
+            for (int k = 0; k < n; ++k) {
+                matrix[col * n + k] /= scale;
+                inverse[col * n + k] /= scale;
+            }
+            for (int row = 0; row < n; ++row) {
+                if (row == col) continue;
+                double factor = matrix[row * n + col];
+                for (int k = 0; k < n; ++k) {
+                    matrix[row * n + k] -= factor * matrix[col * n + k];
+                    inverse[row * n + k] -= factor * inverse[col * n + k];
+                }
+            }
+        }
+        matrix.swap(inverse);
+    }
+
+    // Bradley-Terry maximum likelihood Elo from the pairwise results, with a 95% interval from
+    // the Fisher information. Every pair that met gets one extra virtual draw so a bot that won
+    // or lost everything still has a finite rating.
+    void computeElo(const std::vector<double>& scored, const std::vector<int>& played, std::vector<Standing>& standings) {
+        int n = static_cast<int>(standings.size());
+        std::vector<double> wins(n * n, 0.0);
+        std::vector<double> games(n * n, 0.0);
+        for (int i = 0; i < n * n; ++i) {
+            if (played[i] > 0) {
+                wins[i] = scored[i] + 0.5;
+                games[i] = played[i] + 1.0;
+            }
+        }
+
+        // Minorization-maximization (Hunter 2004) on strengths gamma = 10^(elo / 400)
+        std::vector<double> gamma(n, 1.0);
+        for (int iteration = 0; iteration < 10000; ++iteration) {
+            double change = 0.0;
+            for (int i = 0; i < n; ++i) {
+                double won = 0.0;
+                double denominator = 0.0;
+                for (int j = 0; j < n; ++j) {
+                    if (games[i * n + j] == 0.0) continue;
+                    won += wins[i * n + j];
+                    denominator += games[i * n + j] / (gamma[i] + gamma[j]);
+                }
+                if (denominator == 0.0) continue;
+                double updated = won / denominator;
+                change = std::max(change, std::fabs(std::log(updated / gamma[i])));
+                gamma[i] = updated;
+            }
+            double logMean = 0.0;
+            for (int i = 0; i < n; ++i) logMean += std::log(gamma[i]) / n;
+            for (int i = 0; i < n; ++i) gamma[i] /= std::exp(logMean);
+            if (change < 1e-10) break;
+        }
+
+        // Covariance of the log-strengths with their mean pinned at 0: pseudo-inverse of the
+        // information matrix, (L + J/n)^-1 - J/n
+        std::vector<double> information(n * n, 0.0);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                if (i == j || games[i * n + j] == 0.0) continue;
+                double p = gamma[i] / (gamma[i] + gamma[j]);
+                double weight = games[i * n + j] * p * (1.0 - p);
+                information[i * n + j] -= weight;
+                information[i * n + i] += weight;
+            }
+        }
+        for (int i = 0; i < n * n; ++i) information[i] += 1.0 / n;
+        invert(information, n);
+
+        const double ELO_PER_NATURAL_LOG = 400.0 / std::log(10.0);
+        for (int i = 0; i < n; ++i) {
+            standings[i].elo = std::log(gamma[i]) * ELO_PER_NATURAL_LOG;
+            double variance = std::max(0.0, information[i * n + i] - 1.0 / n);
+            standings[i].eloError = 1.96 * std::sqrt(variance) * ELO_PER_NATURAL_LOG;
+        }
+    }
+
+    // Swiss pairing: sort by points and pair each entrant with the next one it has not met yet,
+    // falling back to a rematch when everyone left has been met. An odd entrant out sits out.
+    std::vector<Pairing> swissPairings(const std::vector<Standing>& standings, const std::vector<int>& played) {
+        int n = static_cast<int>(standings.size());
+        std::vector<int> order(n);
+        for (int i = 0; i < n; ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](int x, int y) { return standings[x].points > standings[y].points; });
+
+        std::vector<bool> paired(n, false);
+        std::vector<Pairing> pairings;
+        for (int i = 0; i < n; ++i) {
+            int a = order[i];
+            if (paired[a]) continue;
+            int opponent = -1;
+            for (int j = i + 1; j < n && opponent < 0; ++j) {
+                int b = order[j];
+                if (!paired[b] && played[a * n + b] == 0) opponent = b;
+            }
+            for (int j = i + 1; j < n && opponent < 0; ++j) {
+                if (!paired[order[j]]) opponent = order[j];
+            }
+            if (opponent < 0) break;
+            paired[a] = true;
+            paired[opponent] = true;
+            pairings.push_back(Pairing{ a, opponent });
+        }
+        return pairings;
+    }
+}
+
+std::unique_ptr<Policy> makePolicy(const std::string& spec) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (true) {
+        size_t colon = spec.find(':', start);
+        parts.push_back(spec.substr(start, colon - start));
+        if (colon == std::string::npos) break;
+        start = colon + 1;
+    }
+    auto parameter = [&](size_t index, int fallback) {
+        return index < parts.size() ? std::max(1, std::atoi(parts[index].c_str())) : fallback;
+    };
+
+    if (parts[0] == "greedy") return std::unique_ptr<Policy>(new GreedyPolicy());
+    if (parts[0] == "rollout") return std::unique_ptr<Policy>(new RolloutPolicy(parameter(1, 8), parameter(2, 4)));
+    if (parts[0] == "expectimax") return std::unique_ptr<Policy>(new ExpectimaxPolicy(parameter(1, 4)));
+    return nullptr;
+}
+
+std::vector<Standing> runTournament(const std::vector<const Policy*>& entrants, const TournamentConfig& config,
+    uint64_t& gamesPlayed) {
+    int n = static_cast<int>(entrants.size());
+    int gamesPerPairing = std::max(2, (config.gamesPerPairing + 1) / 2 * 2);
+    int threads = config.threads > 0 ? config.threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    std::vector<Standing> standings(n);
+    for (int i = 0; i < n; ++i) {
+        standings[i] = Standing{ entrants[i]->name(), 0, 0.0, 0, 0, 0, 0.0, 0.0 };
+    }
+    std::vector<double> scored(n * n, 0.0); // scored[a * n + b]: points a took from b
+    std::vector<int> played(n * n, 0);
+    gamesPlayed = 0;
+
+    int rounds = config.format == TournamentConfig::SWISS ? config.swissRounds : 1;
+    for (int round = 0; round < rounds; ++round) {
+        std::vector<Pairing> pairings;
+        if (config.format == TournamentConfig::SWISS) {
+            pairings = swissPairings(standings, played);
+        }
+        else {
+            for (int a = 0; a < n; ++a) {
+                for (int b = a + 1; b < n; ++b) {
+                    pairings.push_back(Pairing{ a, b });
+                }
+            }
+        }
+
+        std::vector<double> results;
+        playPairings(entrants, pairings, gamesPerPairing, mixSeed(config.seed + round), threads, results);
+
+        for (size_t p = 0; p < pairings.size(); ++p) {
+            int a = pairings[p].a;
+            int b = pairings[p].b;
+            for (int g = 0; g < gamesPerPairing; ++g) {
+                double result = results[p * gamesPerPairing + g];
+                scored[a * n + b] += result;
+                scored[b * n + a] += 1.0 - result;
+                played[a * n + b]++;
+                played[b * n + a]++;
+                standings[a].points += result;
+                standings[b].points += 1.0 - result;
+                standings[a].games++;
+                standings[b].games++;
+                if (result == 0.5) {
+                    standings[a].draws++;
+                    standings[b].draws++;
+                }
+                else {
+                    (result > 0.5 ? standings[a].wins : standings[a].losses)++;
+                    (result > 0.5 ? standings[b].losses : standings[b].wins)++;
+                }
+            }
+        }
+        gamesPlayed += results.size();
+    }
+
+    computeElo(scored, played, standings);
+    std::stable_sort(standings.begin(), standings.end(), [](const Standing& x, const Standing& y) { return x.elo > y.elo; });
+    return standings;
+}
+
+int runTournamentCommand(int argc, char* argv[]) {
+    TournamentConfig config;
+    std::vector<std::unique_ptr<Policy>> policies;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--swiss" && i + 1 < argc) {
+            config.format = TournamentConfig::SWISS;
+            config.swissRounds = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--games" && i + 1 < argc) {
+            config.gamesPerPairing = std::atoi(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            config.threads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else {
+            std::unique_ptr<Policy> policy = makePolicy(arg);
+            if (!policy) {
+                std::fprintf(stderr, "Unknown policy '%s' (expected greedy, rollout[:playouts[:plies]] or expectimax[:samples])\n", arg.c_str());
+                return 1;
+            }
+            policies.push_back(std::move(policy));
+        }
+    }
+    if (policies.empty()) {
+        policies.push_back(makePolicy("greedy"));
+        policies.push_back(makePolicy("rollout"));
+        policies.push_back(makePolicy("expectimax"));
+    }
+    if (policies.size() < 2) {
+        std::fprintf(stderr, "A tournament needs at least two policies\n");
+        return 1;
+    }
+
+    std::vector<const Policy*> entrants;
+    for (const auto& policy : policies) {
+        entrants.push_back(policy.get());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t gamesPlayed;
+    std::vector<Standing> standings = runTournament(entrants, config, gamesPlayed);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%s, %zu entrants, %llu games in %.1f s (%.0f games/s)\n",
+        config.format == TournamentConfig::SWISS ? "Swiss" : "Round robin", entrants.size(),
+        static_cast<unsigned long long>(gamesPlayed), seconds, gamesPlayed / seconds);
+    std::printf("%-4s %-20s %8s %8s %8s %18s\n", "Rank", "Policy", "Elo", "95% CI", "Games", "W-D-L");
+    for (size_t i = 0; i < standings.size(); ++i) {
+        const Standing& s = standings[i];
+        char interval[32];
+        char record[48];
+        std::snprintf(interval, sizeof(interval), "+/-%.0f", s.eloError);
+        std::snprintf(record, sizeof(record), "%d-%d-%d", s.wins, s.draws, s.losses);
+        std::printf("%-4zu %-20s %8.0f %8s %8d %18s\n", i + 1, s.name.c_str(), s.elo, interval, s.games, record);
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "vec_env.h"
+
+// What a bot sees when it is asked for a move
+struct BotView {
+    uint8_t board[VectorEnv::CELLS]; // Same cell values as VectorEnv
+    int32_t myScore;
+    int32_t opponentScore;
+    int movesLeft; // Shared by both players, as in Game
+};
+
+// A pluggable AI player. chooseAction must return a legal action (see VectorEnv::isLegalAction)
+// and may only keep state in rng, because one instance plays many games on many threads at once.
+// rng is the bot's own generator: it never sees the gems the game will actually refill.
+class Policy {
+public:
+    virtual ~Policy() {}
+    virtual int chooseAction(const BotView& view, uint32_t& rng) const = 0;
+    const std::string& name() const { return label; }
+
+protected:
+    std::string label;
+};
+
+// Creates a policy from a spec such as "greedy", "rollout:8:4" (playouts per move, plies per
+// playout) or "expectimax:4" (refill samples per move). Returns nullptr for an unknown spec.
+std::unique_ptr<Policy> makePolicy(const std::string& spec);
+
+struct TournamentConfig {
+    enum Format { ROUND_ROBIN, SWISS };
+    Format format = ROUND_ROBIN;
+    int gamesPerPairing = 100; // Rounded up to an even number so both bots move first equally often
+    int swissRounds = 5;
+    int threads = 0; // 0 uses every hardware thread
+    uint64_t seed = 1;
+};
+
+struct Standing {
+    std::string name;
+    int games;
+    double points; // 1 per win, 0.5 per draw
+    int wins;
+    int draws;
+    int losses;
+    double elo; // Relative to the field's average of 0
+    double eloError; // 95% confidence half-width
+};
+
+// Plays the tournament and returns the standings sorted by Elo.
+// Every game's refills come from a seed derived from config.seed and the game's place in the
+// schedule, so the same entrants and config always produce the same results on any thread count.
+std::vector<Standing> runTournament(const std::vector<const Policy*>& entrants, const TournamentConfig& config,
+    uint64_t& gamesPlayed);
+
+// Entry point for "project04 --tournament [--swiss rounds] [--games n] [--threads n] [--seed n] policy..."
+int runTournamentCommand(int argc, char* argv[]);
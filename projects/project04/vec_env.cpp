@@ -0,0 +1,287 @@
+// vec_env.cpp
+
+#include "vec_env.h"
+#include "../common/match3_core.h"
+#include <algorithm>
+
+namespace {
+    const int N = VectorEnv::GRID_SIZE;
+
+    typedef Match3::FixedBoard<N, N> Board;
+    typedef Match3::Rules<Board, Match3::FlatScoring<VectorEnv::POINTS_PER_GEM>> Rules;
+
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // Draws gem types 1-5 like Game, from one game's xorshift state
+    struct GemSource {
+        uint32_t& state;
+        int operator()() { return 1 + static_cast<int>(nextRandom(state) % Match3::GEM_KINDS); }
+    };
+
+    bool swapMakesMatch(const uint8_t* cells, int action) {
+        int r1, c1, r2, c2;
+        VectorEnv::decodeAction(action, r1, c1, r2, c2);
+        return Rules::swapFormsMatch(Board(cells), r1, c1, r2, c2);
+    }
+
+    // Resolves every cascade after a swap and returns the points scored. With a log, appends
+    // each cascade's cleared cells (bit row * GRID_SIZE + col) to masks and the gems that
+    // refilled them to refills, column by column and each column bottom up.
+    int resolveCascades(Board& board, uint32_t& rng, std::vector<uint64_t>* masks, std::vector<uint8_t>* refills) {
+        GemSource nextGem = { rng };
+        if (!masks) {
+            return Rules::resolve(board, 1, nextGem).points;
+        }
+        int points = 0;
+        for (int cascade = 0; ; ++cascade) {
+            uint64_t matched = 0;
+            Match3::Cleared cleared = Rules::clearMatches(board, 1, cascade, [&matched](int r, int c, int) {
+                matched |= uint64_t(1) << (r * N + c);
+            });
+            if (cleared.gems == 0) return points;
+            points += cleared.points;
+            masks->push_back(matched);
+            Rules::refill(board, Rules::drop(board), nextGem, [&board, refills](int r, int c, int) {
+                refills->push_back(board[r][c]);
+            });
+        }
+    }
+}
+
+VectorEnv::VectorEnv(int threadCount) : count(0), boards(nullptr), recording(false), generation(0), pendingWorkers(0), stopping(false),
+jobActions(nullptr), jobRewards(nullptr), jobDones(nullptr), jobEnvs(nullptr), jobCount(0) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    // Slice 0 runs on the calling thread, the rest on workers
+    for (int slice = 1; slice < threadCount; ++slice) {
+        workers.emplace_back(&VectorEnv::workerLoop, this, slice);
+    }
+}
+
+VectorEnv::~VectorEnv() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void VectorEnv::reset(int newCount, uint8_t* observations, uint32_t seed) {
+    count = newCount;
+    boards = observations;
+    player1Score.assign(count, 0);
+    player2Score.assign(count, 0);
+    movesLeftCount.assign(count, static_cast<int32_t>(MAX_MOVES));
+    currentPlayer.assign(count, 0);
+    lastOutcome.assign(count, ONGOING);
+    rngState.resize(count);
+    if (recording) {
+        cascadeMasks.resize(count);
+        cascadeRefills.resize(count);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        // Spread the seed so neighboring games do not start from correlated states (xorshift must not be 0)
+        uint32_t state = seed + 0x9E3779B9u * static_cast<uint32_t>(i + 1);
+        state = (state ^ (state >> 16)) * 0x85EBCA6Bu;
+        state ^= state >> 13;
+        rngState[i] = state != 0 ? state : 1;
+        resetOne(i);
+    }
+}
+
+void VectorEnv::resetOne(int env) {
+    dealBoard(boards + static_cast<size_t>(env) * CELLS, rngState[env]);
+    player1Score[env] = 0;
+    player2Score[env] = 0;
+    movesLeftCount[env] = MAX_MOVES;
+    currentPlayer[env] = 0;
+}
+
+void VectorEnv::dealBoard(uint8_t* board, uint32_t& rng) {
+    // Same as Game::initializeBoard: no match already on the board and at least one valid move
+    Board view(board);
+    GemSource nextGem = { rng };
+    Rules::deal(view, nextGem);
+}
+
+bool VectorEnv::isLegalAction(const uint8_t* board, int action) {
+    return action >= 0 && action < ACTION_COUNT && swapMakesMatch(board, action);
+}
+
+bool VectorEnv::hasLegalAction(const uint8_t* board) {
+    return Rules::hasValidMoves(Board(board));
+}
+
+int VectorEnv::immediateClearCount(const uint8_t* board, int action) {
+    if (!isLegalAction(board, action)) return 0;
+    uint8_t copy[CELLS];
+    std::copy(board, board + CELLS, copy);
+    int r1, c1, r2, c2;
+    decodeAction(action, r1, c1, r2, c2);
+    std::swap(copy[r1 * N + c1], copy[r2 * N + c2]);
+    Board view(copy);
+    return Rules::clearMatches(view, 1).gems;
+}
+
+int VectorEnv::playAction(uint8_t* board, int action, uint32_t& rng) {
+    if (!isLegalAction(board, action)) return 0;
+    int r1, c1, r2, c2;
+    decodeAction(action, r1, c1, r2, c2);
+    std::swap(board[r1 * N + c1], board[r2 * N + c2]);
+    Board view(board);
+    GemSource nextGem = { rng };
+    return Rules::resolve(view, 1, nextGem).gems;
+}
+
+void VectorEnv::setRecordCascades(bool enable) {
+    recording = enable;
+    cascadeMasks.assign(enable ? count : 0, std::vector<uint64_t>());
+    cascadeRefills.assign(enable ? count : 0, std::vector<uint8_t>());
+}
+
+void VectorEnv::decodeAction(int action, int& r1, int& c1, int& r2, int& c2) {
+    if (action < HORIZONTAL_SWAPS) {
+        r1 = action / (N - 1);
+        c1 = action % (N - 1);
+        r2 = r1;
+        c2 = c1 + 1;
+    }
+    else {
+        action -= HORIZONTAL_SWAPS;
+        r1 = action / N;
+        c1 = action % N;
+        r2 = r1 + 1;
+        c2 = c1;
+    }
+}
+
+bool VectorEnv::isLegal(int env, int action) const {
+    return isLegalAction(boards + static_cast<size_t>(env) * CELLS, action);
+}
+
+void VectorEnv::step(const int32_t* actions, float* rewards, uint8_t* dones) {
+    step(actions, rewards, dones, nullptr, count);
+}
+
+void VectorEnv::step(const int32_t* actions, float* rewards, uint8_t* dones, const int32_t* envs, int envCount) {
+    const int MIN_GAMES_PER_THREAD = 64; // Below this the hand-off costs more than it saves
+    if (workers.empty() || envCount < MIN_GAMES_PER_THREAD * 2) {
+        jobActions = actions;
+        jobRewards = rewards;
+        jobDones = dones;
+        jobEnvs = envs;
+        jobCount = envCount;
+        stepRange(0, envCount);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        jobActions = actions;
+        jobRewards = rewards;
+        jobDones = dones;
+        jobEnvs = envs;
+        jobCount = envCount;
+        pendingWorkers = static_cast<int>(workers.size());
+        generation++;
+    }
+    wakeWorkers.notify_all();
+
+    int begin, end;
+    sliceBounds(0, begin, end);
+    stepRange(begin, end);
+
+    std::unique_lock<std::mutex> lock(poolMutex);
+    workersDone.wait(lock, [this] { return pendingWorkers == 0; });
+}
+
+void VectorEnv::sliceBounds(int slice, int& begin, int& end) const {
+    int slices = static_cast<int>(workers.size()) + 1;
+    begin = static_cast<int>(static_cast<int64_t>(jobCount) * slice / slices);
+    end = static_cast<int>(static_cast<int64_t>(jobCount) * (slice + 1) / slices);
+}
+
+void VectorEnv::workerLoop(int slice) {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            wakeWorkers.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        int begin, end;
+        sliceBounds(slice, begin, end);
+        stepRange(begin, end);
+
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            pendingWorkers--;
+        }
+        workersDone.notify_one();
+    }
+}
+
+void VectorEnv::stepRange(int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+        int env = jobEnvs ? jobEnvs[i] : i;
+        stepOne(env, jobActions[env], jobRewards[env], jobDones[env]);
+    }
+}
+
+void VectorEnv::stepOne(int env, int action, float& reward, uint8_t& done) {
+    uint8_t* board = boards + static_cast<size_t>(env) * CELLS;
+    reward = 0.0f;
+    done = 0;
+
+    if (recording) { // An ignored action leaves an empty log
+        cascadeMasks[env].clear();
+        cascadeRefills[env].clear();
+    }
+
+    if (!isLegalAction(board, action)) return; // Game::play ignores swaps that form no match
+
+    int r1, c1, r2, c2;
+    decodeAction(action, r1, c1, r2, c2);
+    std::swap(board[r1 * N + c1], board[r2 * N + c2]);
+    Board view(board);
+    int points = resolveCascades(view, rngState[env], recording ? &cascadeMasks[env] : nullptr,
+        recording ? &cascadeRefills[env] : nullptr);
+    if (currentPlayer[env] == 0) {
+        player1Score[env] += points;
+    }
+    else {
+        player2Score[env] += points;
+    }
+    reward = static_cast<float>(points);
+
+    // Same order of checks as Game::endTurn
+    movesLeftCount[env]--;
+    uint8_t outcome = ONGOING;
+    if (player1Score[env] >= WIN_SCORE || player2Score[env] >= WIN_SCORE) {
+        outcome = WIN;
+    }
+    else if (movesLeftCount[env] <= 0 || !Rules::hasValidMoves(view)) {
+        outcome = LOSE;
+    }
+    else {
+        currentPlayer[env] ^= 1;
+    }
+
+    if (outcome != ONGOING) {
+        lastOutcome[env] = outcome;
+        done = 1;
+        resetOne(env);
+    }
+}
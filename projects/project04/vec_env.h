@@ -0,0 +1,116 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Batched, headless version of the Game rules for reinforcement-learning training.
+// N boards are stored back to back in a caller-owned observation buffer (one byte per cell,
+// 0 = EMPTY through 5 = MAGENTA_GEM like Game::GemType) and the per-game state is kept in
+// parallel arrays. step() writes rewards and done flags straight into caller buffers and
+// splits the boards across a persistent set of worker threads.
+//
+// The rules follow Game: a swap must form a match or it is ignored, every cleared gem is
+// worth 100 points, cascades resolve fully within one step, each player turn uses one of
+// MAX_MOVES and reaching WIN_SCORE wins. The points are Game's built-in table, since score
+// files only retune Game. A finished game is reset in place by step() and reported through
+// its done flag and lastOutcomes().
+class VectorEnv {
+public:
+    static const int GRID_SIZE = 8; // Same as Game::GRID_SIZE
+    static const int CELLS = GRID_SIZE * GRID_SIZE;
+    static const int HORIZONTAL_SWAPS = GRID_SIZE * (GRID_SIZE - 1);
+    static const int ACTION_COUNT = 2 * HORIZONTAL_SWAPS; // Every horizontal, then every vertical, adjacent swap
+    static const int MAX_MOVES = 30; // Same as Game::MAX_MOVES
+    static const int WIN_SCORE = 10000; // Same as Game::WIN_SCORE
+    static const int POINTS_PER_GEM = 100; // Same as Game::POINTS_PER_GEM
+
+    enum Outcome : uint8_t { ONGOING, WIN, LOSE }; // Mirrors Game::GameStatus
+
+    // threadCount 0 uses every hardware thread
+    explicit VectorEnv(int threadCount = 0);
+    ~VectorEnv();
+    VectorEnv(const VectorEnv&) = delete;
+    VectorEnv& operator=(const VectorEnv&) = delete;
+
+    // Starts count new games inside observations, which must hold count * CELLS bytes and
+    // must outlive the environment's use of it. The same seed always produces the same games.
+    void reset(int count, uint8_t* observations, uint32_t seed);
+
+    // Applies actions[i] to game i and writes rewards[i] (points scored by the acting player)
+    // and dones[i]. Actions that are out of range or form no match leave the game unchanged.
+    void step(const int32_t* actions, float* rewards, uint8_t* dones);
+
+    // Same as step, but only for the envCount games listed in envs; the other games are left
+    // alone and their entries in actions, rewards and dones are not touched. Cheaper than a full
+    // step when only a few games have an action, as in a server where moves arrive one by one.
+    void step(const int32_t* actions, float* rewards, uint8_t* dones, const int32_t* envs, int envCount);
+
+    int size() const { return count; }
+
+    // Per-game state, indexed by game
+    const int32_t* player1Scores() const { return player1Score.data(); }
+    const int32_t* player2Scores() const { return player2Score.data(); }
+    const int32_t* movesLeft() const { return movesLeftCount.data(); }
+    const uint8_t* currentPlayers() const { return currentPlayer.data(); } // 0 = PLAYER_1, 1 = PLAYER_2
+    const uint8_t* lastOutcomes() const { return lastOutcome.data(); } // Outcome of the last finished game
+
+    const uint8_t* board(int env) const { return boards + static_cast<size_t>(env) * CELLS; }
+
+    // Keeps, for every game, a log of how its last step resolved: the cells cleared by each
+    // cascade and the gems that refilled them (see Match3::Rules::refill for the order). Replaying the
+    // log on the board from before the step reproduces the board after it. Off by default.
+    void setRecordCascades(bool enable);
+    int cascadeCount(int env) const { return static_cast<int>(cascadeMasks[env].size()); } // 0 if the action was ignored
+    uint64_t clearedMask(int env, int cascade) const { return cascadeMasks[env][cascade]; } // Bit row * GRID_SIZE + col
+    const std::vector<uint8_t>& refillGems(int env) const { return cascadeRefills[env]; }
+
+    // Whether action would be accepted by game env right now
+    bool isLegal(int env, int action) const;
+
+    // Converts an action index into the two cells it swaps
+    static void decodeAction(int action, int& r1, int& c1, int& r2, int& c2);
+
+    // Single-board versions of the rules, for bots that search ahead on copies of a board.
+    // rng is an xorshift32 state and must not be 0.
+    static void dealBoard(uint8_t* board, uint32_t& rng); // A fresh board with no matches
+    static bool isLegalAction(const uint8_t* board, int action);
+    static bool hasLegalAction(const uint8_t* board);
+    static int immediateClearCount(const uint8_t* board, int action); // Gems the swap clears before anything falls
+    static int playAction(uint8_t* board, int action, uint32_t& rng); // Resolves every cascade, returns gems cleared (0 if illegal)
+
+private:
+    int count;
+    uint8_t* boards; // Caller-owned, count * CELLS bytes
+    std::vector<int32_t> player1Score;
+    std::vector<int32_t> player2Score;
+    std::vector<int32_t> movesLeftCount;
+    std::vector<uint8_t> currentPlayer;
+    std::vector<uint8_t> lastOutcome;
+    std::vector<uint32_t> rngState; // xorshift32 state per game
+    bool recording;
+    std::vector<std::vector<uint64_t>> cascadeMasks; // Per game, only while recording
+    std::vector<std::vector<uint8_t>> cascadeRefills;
+
+    // Worker pool; each worker handles a fixed slice of the games
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable workersDone;
+    uint64_t generation;
+    int pendingWorkers;
+    bool stopping;
+    const int32_t* jobActions;
+    float* jobRewards;
+    uint8_t* jobDones;
+    const int32_t* jobEnvs; // Games to step, or nullptr for all of them
+    int jobCount;
+
+    void workerLoop(int slice);
+    void stepRange(int begin, int end); // Positions in jobEnvs, or games when it is null
+    void stepOne(int env, int action, float& reward, uint8_t& done);
+    void resetOne(int env);
+    void sliceBounds(int slice, int& begin, int& end) const;
+};
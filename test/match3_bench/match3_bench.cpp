@@ -0,0 +1,638 @@
+// Microbenchmarks for the match-3 rules as project02 and project04 use them, so a change to
+// projects/common/match3_core.h (or to either game's rules) can be checked for regressions.
+//
+// Each operation is timed on its own, on boards in the state the game hands it:
+//   hasMatches, hasValidMoves - freshly dealt boards (no match, so hasMatches checks every cell)
+//   clearMatches              - boards just after a legal swap
+//   dropGems                  - boards just after clearMatches
+//   refillBoard               - boards just after dropGems
+//   turn                      - a dealt board: play its first legal swap, resolve every cascade
+//                               and check for a next move, as both games do each turn
+//   step                      - (project04 only) one VectorEnv::step, reported per game
+// For the operations that change the board, restoring its input before each call is timed
+// separately and subtracted.
+//
+// project02 is measured through the same Rules instantiation as its Game (GridBoard of
+// Game::GemType, GemValueScoring) at several sizes; project04 through VectorEnv's FixedBoard
+// rules, which are the ones its bots and server run. project04's SDL Game is not built here.
+//
+// Reported per operation: ns, heap allocations and, on Linux where perf events are allowed,
+// cache misses (null otherwise). Each figure is the median of several samples.
+//
+// Build and run on Linux from the repository root:
+//   g++ -O2 -std=c++17 test/match3_bench/match3_bench.cpp projects/project04/vec_env.cpp -lpthread -o match3_bench
+//   ./match3_bench --json after.json [--compare before.json] [--threshold 10]
+// --compare exits with 1 if any operation is more than threshold percent slower than in the
+// baseline, or allocates more, so it can gate a commit.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../projects/common/match3_core.h"
+#include "../../projects/project02/game.h"
+#include "../../projects/project04/vec_env.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Every heap allocation in the process is counted, so an operation that starts allocating shows up
+static std::atomic<long long> allocationCount(0);
+
+// Every form of new and delete is replaced, so array and over-aligned allocations are counted
+// too and each block is freed by the function that matches how it was allocated.
+static void* countedAllocate(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size > 0 ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+static void* countedAllocate(std::size_t size, std::align_val_t alignment)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    size = (size + align - 1) / align * align; // aligned_alloc wants a multiple of the alignment
+#ifdef _WIN32
+    void* memory = _aligned_malloc(size > 0 ? size : align, align);
+#else
+    void* memory = std::aligned_alloc(align, size > 0 ? size : align);
+#endif
+    if (memory)
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+static void countedRelease(void* memory, std::align_val_t)
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+static void countedRelease(void* memory)
+{
+    std::free(memory);
+}
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedAllocate(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return countedAllocate(size, alignment); }
+
+void operator delete(void* memory) noexcept { countedRelease(memory); }
+void operator delete[](void* memory) noexcept { countedRelease(memory); }
+void operator delete(void* memory, std::size_t) noexcept { countedRelease(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { countedRelease(memory); }
+void operator delete(void* memory, std::align_val_t alignment) noexcept { countedRelease(memory, alignment); }
+void operator delete[](void* memory, std::align_val_t alignment) noexcept { countedRelease(memory, alignment); }
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept { countedRelease(memory, alignment); }
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept { countedRelease(memory, alignment); }
+
+namespace
+{
+    const int SAMPLES = 5;
+    const int CELLS_PER_SAMPLE = 2000000; // Iterations per sample are scaled so each board size does about this much work
+    const int VECTOR_ENV_GAMES = 256;
+    const double MIN_REGRESSION_NS = 5.0; // Smaller slowdowns are within timer noise, whatever the percentage
+
+    // Counts last-level cache misses of this thread in user space, where the kernel allows it
+    class CacheMissCounter
+    {
+    public:
+        CacheMissCounter() : fd(-1)
+        {
+#ifdef __linux__
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+
+        ~CacheMissCounter()
+        {
+#ifdef __linux__
+            if (fd >= 0) close(fd);
+#endif
+        }
+
+        CacheMissCounter(const CacheMissCounter&) = delete;
+        CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+        bool available() const { return fd >= 0; }
+
+        void start()
+        {
+#ifdef __linux__
+            if (fd < 0) return;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+        }
+
+        long long stop()
+        {
+            long long misses = 0;
+#ifdef __linux__
+            if (fd < 0) return 0;
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &misses, sizeof(misses)) != sizeof(misses)) misses = 0;
+#endif
+            return misses;
+        }
+
+    private:
+        int fd;
+    };
+
+    CacheMissCounter cacheMisses;
+
+    // One operation at one board size
+    struct Result
+    {
+        std::string project;
+        std::string op;
+        int rows;
+        int cols;
+        double nsPerOp;
+        double allocsPerOp;
+        double cacheMissesPerOp; // Negative when not measured
+        long long iterations; // Per sample
+    };
+
+    struct Totals
+    {
+        double ns;
+        long long allocations;
+        long long misses;
+    };
+
+    volatile int sink = 0; // Keeps results from being optimized away
+
+    template <typename Prepare, typename Op>
+    Totals runLoop(int iterations, Prepare& prepare, Op& op)
+    {
+        typedef std::chrono::steady_clock Clock;
+        int local = 0;
+        long long allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        cacheMisses.start();
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            prepare(i);
+            local += op(i);
+        }
+        Totals totals;
+        totals.ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        totals.misses = cacheMisses.stop();
+        totals.allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        sink = sink + local;
+        return totals;
+    }
+
+    // Times op(i) after prepare(i), minus prepare(i) on its own, and keeps the median sample.
+    // op returns something derived from its work so the call cannot be dropped.
+    template <typename Prepare, typename Op>
+    Result measure(const char* project, const char* op, int rows, int cols, int iterations, Prepare prepare, Op body)
+    {
+        auto nothing = [](int) { return 0; };
+        std::vector<Result> samples;
+        for (int s = 0; s < SAMPLES; ++s)
+        {
+            Totals setup = runLoop(iterations, prepare, nothing);
+            Totals total = runLoop(iterations, prepare, body);
+            Result sample;
+            sample.nsPerOp = std::max(0.0, total.ns - setup.ns) / iterations;
+            sample.allocsPerOp = static_cast<double>(std::max(0LL, total.allocations - setup.allocations)) / iterations;
+            sample.cacheMissesPerOp = cacheMisses.available() ?
+                static_cast<double>(std::max(0LL, total.misses - setup.misses)) / iterations : -1.0;
+            samples.push_back(sample);
+        }
+        std::sort(samples.begin(), samples.end(), [](const Result& a, const Result& b) { return a.nsPerOp < b.nsPerOp; });
+        Result result = samples[SAMPLES / 2];
+        result.project = project;
+        result.op = op;
+        result.rows = rows;
+        result.cols = cols;
+        result.iterations = iterations;
+        return result;
+    }
+
+    // xorshift32 gem source, reseeded per sample so every sample does the same work
+    struct Gems
+    {
+        uint32_t state;
+
+        int operator()()
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return 1 + static_cast<int>(state % Match3::GEM_KINDS);
+        }
+    };
+
+    const uint32_t GEM_SEED = 2463534242u;
+
+    // Boards captured at each point of a turn, so each operation starts from realistic input
+    template <typename Cell>
+    struct Inputs
+    {
+        std::vector<std::vector<Cell>> dealt;
+        std::vector<std::vector<Cell>> swapped;
+        std::vector<std::vector<Cell>> cleared;
+        std::vector<std::vector<Cell>> dropped;
+        std::vector<std::vector<int>> falls; // What dropGems returned for each dropped board
+        std::vector<int> moves; // First legal swap on each dealt board: r1, c1, r2, c2
+    };
+
+    template <typename Board>
+    std::vector<typename Board::Cell> capture(const Board& board)
+    {
+        const typename Board::Cell* cells = board[0];
+        return std::vector<typename Board::Cell>(cells, cells + board.rows() * board.cols());
+    }
+
+    template <typename Board, typename Cell>
+    void restore(Board& board, const std::vector<Cell>& cells)
+    {
+        std::copy(cells.begin(), cells.end(), board[0]);
+    }
+
+    // The same inputs as boards of their own, so read-only operations are timed without a copy
+    template <typename Cell>
+    std::vector<Match3::GridBoard<Cell>> readOnlyBoards(const Match3::GridBoard<Cell>& shape, const std::vector<std::vector<Cell>>& pool)
+    {
+        std::vector<Match3::GridBoard<Cell>> boards(pool.size(), Match3::GridBoard<Cell>(shape.rows(), shape.cols()));
+        for (size_t i = 0; i < pool.size(); ++i)
+        {
+            restore(boards[i], pool[i]);
+        }
+        return boards;
+    }
+
+    template <int Rows, int Cols>
+    std::vector<Match3::FixedBoard<Rows, Cols>> readOnlyBoards(const Match3::FixedBoard<Rows, Cols>&, const std::vector<std::vector<uint8_t>>& pool)
+    {
+        std::vector<Match3::FixedBoard<Rows, Cols>> boards;
+        for (const std::vector<uint8_t>& cells : pool)
+        {
+            boards.push_back(Match3::FixedBoard<Rows, Cols>(cells.data()));
+        }
+        return boards;
+    }
+
+    template <typename Board, typename Scoring>
+    bool firstLegalSwap(const Board& board, int move[4])
+    {
+        typedef Match3::Rules<Board, Scoring> Rules;
+        for (int r = 0; r < board.rows(); ++r)
+        {
+            for (int c = 0; c < board.cols(); ++c)
+            {
+                if (c + 1 < board.cols() && Rules::swapFormsMatch(board, r, c, r, c + 1))
+                {
+                    move[0] = r; move[1] = c; move[2] = r; move[3] = c + 1;
+                    return true;
+                }
+                if (r + 1 < board.rows() && Rules::swapFormsMatch(board, r, c, r + 1, c))
+                {
+                    move[0] = r; move[1] = c; move[2] = r + 1; move[3] = c;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    template <typename Board, typename Scoring>
+    Inputs<typename Board::Cell> makeInputs(Board& board, int count)
+    {
+        typedef Match3::Rules<Board, Scoring> Rules;
+        Inputs<typename Board::Cell> inputs;
+        Gems gems = { GEM_SEED };
+        while (static_cast<int>(inputs.dealt.size()) < count)
+        {
+            Rules::deal(board, gems);
+            int move[4];
+            if (!firstLegalSwap<Board, Scoring>(board, move)) continue; // deal guarantees one, but be safe
+            inputs.dealt.push_back(capture(board));
+            inputs.moves.insert(inputs.moves.end(), move, move + 4);
+            std::swap(board[move[0]][move[1]], board[move[2]][move[3]]);
+            inputs.swapped.push_back(capture(board));
+            Rules::clearMatches(board, 1);
+            inputs.cleared.push_back(capture(board));
+            const int* fall = Rules::drop(board);
+            inputs.dropped.push_back(capture(board));
+            inputs.falls.push_back(std::vector<int>(fall, fall + board.cols()));
+        }
+        return inputs;
+    }
+
+    // Measures every rules operation on board, which is resized or viewed by the caller
+    template <typename Board, typename Scoring>
+    void benchmarkRules(const char* project, Board& board, std::vector<Result>& results)
+    {
+        typedef Match3::Rules<Board, Scoring> Rules;
+        const int rows = board.rows();
+        const int cols = board.cols();
+        const int cells = rows * cols;
+        const int iterations = std::max(50, CELLS_PER_SAMPLE / cells);
+        const int poolSize = std::max(4, std::min(256, (1 << 20) / cells)); // Enough boards that branches are not learned
+        Inputs<typename Board::Cell> inputs = makeInputs<Board, Scoring>(board, poolSize);
+        Gems gems = { GEM_SEED };
+
+        auto restoreFrom = [&board](const std::vector<std::vector<typename Board::Cell>>& pool)
+        {
+            return [&board, &pool](int i) { restore(board, pool[i % pool.size()]); };
+        };
+        auto reseed = [&gems](int i) { if (i == 0) gems.state = GEM_SEED; }; // Same gems in every sample
+
+        const std::vector<Board> dealt = readOnlyBoards(board, inputs.dealt);
+        auto noSetup = [](int) {};
+        results.push_back(measure(project, "hasMatches", rows, cols, iterations, noSetup,
+            [&dealt](int i) { return static_cast<int>(Rules::hasMatches(dealt[i % dealt.size()])); }));
+        results.push_back(measure(project, "hasValidMoves", rows, cols, iterations, noSetup,
+            [&dealt](int i) { return static_cast<int>(Rules::hasValidMoves(dealt[i % dealt.size()])); }));
+        results.push_back(measure(project, "clearMatches", rows, cols, iterations, restoreFrom(inputs.swapped),
+            [&board](int) { return Rules::clearMatches(board, 1).gems; }));
+        results.push_back(measure(project, "dropGems", rows, cols, iterations, restoreFrom(inputs.cleared),
+            [&board](int) { return Rules::drop(board)[0]; }));
+
+        // refill only writes the cells each column's fall distance says are empty, so the board is
+        // not restored between calls: that would cost more than the refill on wide boards
+        restore(board, inputs.dropped[0]);
+        results.push_back(measure(project, "refillBoard", rows, cols, iterations, reseed,
+            [&](int i)
+            {
+                Rules::refill(board, inputs.falls[i % inputs.falls.size()].data(), gems);
+                return static_cast<int>(board[0][0]);
+            }));
+
+        auto restoreDealt = restoreFrom(inputs.dealt);
+        results.push_back(measure(project, "turn", rows, cols, iterations,
+            [&](int i) { restoreDealt(i); reseed(i); },
+            [&](int i)
+            {
+                const int* move = &inputs.moves[(i % inputs.dealt.size()) * 4];
+                Match3::Cleared cleared = Rules::play(board, move[0], move[1], move[2], move[3], 1, gems);
+                return cleared.gems + static_cast<int>(Rules::hasValidMoves(board));
+            }));
+    }
+
+    // Whole VectorEnv steps on one thread, each game playing its first legal action.
+    // Picking the actions is done in the untimed setup.
+    void benchmarkVectorEnv(std::vector<Result>& results)
+    {
+        VectorEnv env(1);
+        std::vector<uint8_t> observations(static_cast<size_t>(VECTOR_ENV_GAMES) * VectorEnv::CELLS);
+        std::vector<int32_t> actions(VECTOR_ENV_GAMES);
+        std::vector<float> rewards(VECTOR_ENV_GAMES);
+        std::vector<uint8_t> dones(VECTOR_ENV_GAMES);
+        const int iterations = std::max(50, CELLS_PER_SAMPLE / (VECTOR_ENV_GAMES * VectorEnv::CELLS));
+
+        Result result = measure("project04", "step", VectorEnv::GRID_SIZE, VectorEnv::GRID_SIZE, iterations,
+            [&](int i)
+            {
+                if (i == 0) env.reset(VECTOR_ENV_GAMES, observations.data(), GEM_SEED);
+                for (int game = 0; game < VECTOR_ENV_GAMES; ++game)
+                {
+                    int action = 0;
+                    while (action < VectorEnv::ACTION_COUNT && !env.isLegal(game, action)) ++action;
+                    actions[game] = action;
+                }
+            },
+            [&](int)
+            {
+                env.step(actions.data(), rewards.data(), dones.data());
+                return static_cast<int>(rewards[0]);
+            });
+        // Reported per game so it lines up with turn
+        result.nsPerOp /= VECTOR_ENV_GAMES;
+        result.allocsPerOp /= VECTOR_ENV_GAMES;
+        if (result.cacheMissesPerOp >= 0) result.cacheMissesPerOp /= VECTOR_ENV_GAMES;
+        results.push_back(result);
+    }
+
+    std::string keyOf(const Result& result)
+    {
+        std::ostringstream key;
+        key << result.project << ' ' << result.op << ' ' << result.rows << 'x' << result.cols;
+        return key.str();
+    }
+
+    void printResults(const std::vector<Result>& results)
+    {
+        std::printf("%-10s %-14s %9s %14s %12s %14s\n", "project", "op", "board", "ns/op", "allocs/op", "misses/op");
+        for (const Result& result : results)
+        {
+            char board[32];
+            std::snprintf(board, sizeof(board), "%dx%d", result.rows, result.cols);
+            char misses[32];
+            if (result.cacheMissesPerOp >= 0)
+            {
+                std::snprintf(misses, sizeof(misses), "%14.2f", result.cacheMissesPerOp);
+            }
+            else
+            {
+                std::snprintf(misses, sizeof(misses), "%14s", "n/a");
+            }
+            std::printf("%-10s %-14s %9s %14.1f %12.2f %s\n", result.project.c_str(), result.op.c_str(), board,
+                result.nsPerOp, result.allocsPerOp, misses);
+        }
+    }
+
+    // One result per line, in a fixed order, so two runs diff cleanly
+    bool writeJson(const std::string& path, const std::vector<Result>& results)
+    {
+        std::ofstream file(path);
+        if (!file) return false;
+        file << "{\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& result = results[i];
+            char line[512];
+            char misses[32];
+            if (result.cacheMissesPerOp >= 0)
+            {
+                std::snprintf(misses, sizeof(misses), "%.3f", result.cacheMissesPerOp);
+            }
+            else
+            {
+                std::snprintf(misses, sizeof(misses), "null");
+            }
+            std::snprintf(line, sizeof(line),
+                "    {\"project\": \"%s\", \"op\": \"%s\", \"rows\": %d, \"cols\": %d, \"ns_per_op\": %.1f, "
+                "\"allocs_per_op\": %.3f, \"cache_misses_per_op\": %s, \"iterations\": %lld}%s\n",
+                result.project.c_str(), result.op.c_str(), result.rows, result.cols, result.nsPerOp,
+                result.allocsPerOp, misses, result.iterations, i + 1 < results.size() ? "," : "");
+            file << line;
+        }
+        file << "  ]\n}\n";
+        return static_cast<bool>(file);
+    }
+
+    // Reads back a file written by writeJson; it only needs to understand that layout
+    bool readJson(const std::string& path, std::vector<Result>& results)
+    {
+        std::ifstream file(path);
+        if (!file) return false;
+        auto field = [](const std::string& line, const char* name)
+        {
+            std::string key = std::string("\"") + name + "\": ";
+            size_t start = line.find(key);
+            if (start == std::string::npos) return std::string();
+            start += key.size();
+            size_t end = line.find_first_of(",}", start);
+            std::string value = line.substr(start, end - start);
+            if (!value.empty() && value.front() == '"') value = value.substr(1, value.size() - 2);
+            return value;
+        };
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.find("\"op\"") == std::string::npos) continue;
+            Result result;
+            result.project = field(line, "project");
+            result.op = field(line, "op");
+            result.rows = std::atoi(field(line, "rows").c_str());
+            result.cols = std::atoi(field(line, "cols").c_str());
+            result.nsPerOp = std::atof(field(line, "ns_per_op").c_str());
+            result.allocsPerOp = std::atof(field(line, "allocs_per_op").c_str());
+            std::string misses = field(line, "cache_misses_per_op");
+            result.cacheMissesPerOp = misses == "null" ? -1.0 : std::atof(misses.c_str());
+            result.iterations = std::atoll(field(line, "iterations").c_str());
+            results.push_back(result);
+        }
+        return true;
+    }
+
+    // Prints how each operation moved against the baseline; returns how many regressed
+    int compare(const std::vector<Result>& baseline, const std::vector<Result>& results, double thresholdPercent)
+    {
+        std::map<std::string, Result> before;
+        for (const Result& result : baseline)
+        {
+            before[keyOf(result)] = result;
+        }
+
+        int regressions = 0;
+        std::printf("\n%-36s %12s %12s %9s\n", "compared to baseline", "before ns", "after ns", "change");
+        for (const Result& result : results)
+        {
+            auto found = before.find(keyOf(result));
+            if (found == before.end())
+            {
+                std::printf("%-36s %12s %12.1f %9s\n", keyOf(result).c_str(), "-", result.nsPerOp, "new");
+                continue;
+            }
+            const Result& old = found->second;
+            double change = old.nsPerOp > 0 ? 100.0 * (result.nsPerOp - old.nsPerOp) / old.nsPerOp : 0.0;
+            bool slower = change > thresholdPercent && result.nsPerOp - old.nsPerOp > MIN_REGRESSION_NS;
+            bool allocates = result.allocsPerOp > old.allocsPerOp + 0.001;
+            if (slower || allocates) ++regressions;
+            std::printf("%-36s %12.1f %12.1f %+8.1f%%%s%s\n", keyOf(result).c_str(), old.nsPerOp, result.nsPerOp, change,
+                slower ? "  SLOWER" : "", allocates ? "  ALLOCATES" : "");
+        }
+        return regressions;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string jsonPath;
+    std::string baselinePath;
+    double thresholdPercent = 10.0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else if (arg == "--compare" && i + 1 < argc)
+        {
+            baselinePath = argv[++i];
+        }
+        else if (arg == "--threshold" && i + 1 < argc)
+        {
+            thresholdPercent = std::atof(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--json out.json] [--compare baseline.json] [--threshold percent]\n";
+            return 2;
+        }
+    }
+
+    std::vector<Result> results;
+
+    typedef Match3::GridBoard<Game::GemType> GameBoard; // Same board and scoring as project02's Game
+    const int SIZES[] = { 8, 16, 64, 256 };
+    for (int size : SIZES)
+    {
+        GameBoard board(size, size);
+        benchmarkRules<GameBoard, Match3::GemValueScoring>("project02", board, results);
+    }
+
+    typedef Match3::FixedBoard<VectorEnv::GRID_SIZE, VectorEnv::GRID_SIZE> EnvBoard; // Same as VectorEnv's
+    uint8_t envCells[VectorEnv::CELLS] = {};
+    EnvBoard envBoard(envCells);
+    benchmarkRules<EnvBoard, Match3::FlatScoring<VectorEnv::POINTS_PER_GEM>>("project04", envBoard, results);
+    benchmarkVectorEnv(results);
+
+    printResults(results);
+    if (!cacheMisses.available())
+    {
+        std::cout << "(cache misses need perf events, which this system does not allow)\n";
+    }
+
+    if (!jsonPath.empty() && !writeJson(jsonPath, results))
+    {
+        std::cerr << "Could not write " << jsonPath << "\n";
+        return 2;
+    }
+
+    if (!baselinePath.empty())
+    {
+        std::vector<Result> baseline;
+        if (!readJson(baselinePath, baseline))
+        {
+            std::cerr << "Could not read " << baselinePath << "\n";
+            return 2;
+        }
+        int regressions = compare(baseline, results, thresholdPercent);
+        if (regressions > 0)
+        {
+            std::cout << regressions << " operation(s) regressed by more than " << thresholdPercent << "%\n";
+            return 1;
+        }
+        std::cout << "No regressions\n";
+    }
+    return 0;
+}
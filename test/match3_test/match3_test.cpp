@@ -0,0 +1,598 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../projects/common/board_dataset.h"
+#include "../../projects/common/match3_core.h"
+#include "../../projects/common/match3_hints.h"
+#include "../../projects/common/match3_scoring.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// Correctness tests for the match-3 rules and board storage shared by project01, project02 and project04.
+// Timing lives in test/match3_bench; these check the answers against straightforward scans.
+namespace
+{
+    typedef Match3::GridBoard<int> Board;
+    typedef Match3::Rules<Board, Match3::GemValueScoring> Rules;
+
+    const int GEM_VALUES[] = { 0, 300, 250, 200, 150, 100 }; // GemValueScoring, as the games paid per cell
+
+    // GemValueScoring with crossed groups paid double and no combo
+    struct CrossScoring
+    {
+        static const Match3::ScoreTable& table()
+        {
+            static const Match3::ScoreTable TABLE = build();
+            return TABLE;
+        }
+
+        static Match3::ScoreTable build()
+        {
+            Match3::ScoreRules rules = Match3::GemValueScoring::rules();
+            rules.crossPercent = 200;
+            rules.comboScales = 0;
+            return Match3::buildScoreTable(rules);
+        }
+    };
+
+    // Fills every cell with one of the first kinds gems; few kinds give many matches
+    void randomFill(Board& board, std::mt19937& random, int kinds)
+    {
+        std::uniform_int_distribution<int> gem(1, kinds);
+        for (int r = 0; r < board.rows(); ++r)
+        {
+            for (int c = 0; c < board.cols(); ++c)
+            {
+                board[r][c] = gem(random);
+            }
+        }
+    }
+
+    // The per-cell scan the shared rules replaced: every window of three equal gems marks its
+    // cells. Returns how many cells are marked.
+    int referenceMarks(const Board& board, std::vector<int>& marks)
+    {
+        const int rows = board.rows();
+        const int cols = board.cols();
+        marks.assign(static_cast<size_t>(rows) * cols, 0);
+        for (int r = 0; r < rows; ++r)
+        {
+            for (int c = 0; c < cols; ++c)
+            {
+                int gem = board[r][c];
+                if (gem == Match3::EMPTY) continue;
+                if (c + 2 < cols && board[r][c + 1] == gem && board[r][c + 2] == gem)
+                {
+                    for (int k = 0; k < 3; ++k) marks[r * cols + c + k] = 1;
+                }
+                if (r + 2 < rows && board[r + 1][c] == gem && board[r + 2][c] == gem)
+                {
+                    for (int k = 0; k < 3; ++k) marks[(r + k) * cols + c] = 1;
+                }
+            }
+        }
+        int marked = 0;
+        for (int mark : marks) marked += mark;
+        return marked;
+    }
+
+    // A 5x5 board with no match: every row alternates two gems and every column cycles four
+    void fillWithoutMatches(Board& board)
+    {
+        board.resize(5, 5);
+        for (int r = 0; r < 5; ++r)
+        {
+            for (int c = 0; c < 5; ++c)
+            {
+                board[r][c] = (r + 2 * c) % 4 + 2;
+            }
+        }
+    }
+
+    // Gems cleared straight away by every swap, found by playing each one on a copy
+    bool bruteForceBest(const Board& board, Match3::SwapIndex<Board>::Swap& best)
+    {
+        best.clears = 0;
+        for (int r = 0; r < board.rows(); ++r)
+        {
+            for (int c = 0; c < board.cols(); ++c)
+            {
+                const int targets[2][2] = { { r, c + 1 }, { r + 1, c } }; // Horizontal first, as SwapIndex breaks ties
+                for (const auto& target : targets)
+                {
+                    if (!Rules::inBounds(board, target[0], target[1])) continue;
+                    Board copy = board;
+                    std::swap(copy[r][c], copy[target[0]][target[1]]);
+                    int clears = Rules::clearMatches(copy, 1).gems;
+                    if (clears > best.clears)
+                    {
+                        best = { r, c, target[0], target[1], clears };
+                    }
+                }
+            }
+        }
+        return best.clears > 0;
+    }
+
+    const char* const DATASET_PATH = "match3_test_dataset.gems"; // Written to the working directory, removed by each test
+
+    std::vector<uint8_t> readFile(const char* path)
+    {
+        std::vector<uint8_t> bytes;
+        std::FILE* file = std::fopen(path, "rb");
+        if (!file) return bytes;
+        int byte;
+        while ((byte = std::fgetc(file)) != EOF) bytes.push_back(static_cast<uint8_t>(byte));
+        std::fclose(file);
+        return bytes;
+    }
+
+    void writeFile(const char* path, const std::vector<uint8_t>& bytes)
+    {
+        std::FILE* file = std::fopen(path, "wb");
+        Assert::IsTrue(file != nullptr);
+        if (!bytes.empty()) std::fwrite(bytes.data(), 1, bytes.size(), file);
+        std::fclose(file);
+    }
+
+    // Board i of the test datasets: every gem value 0-7, a different pattern per record
+    int datasetCell(int i, int row, int col)
+    {
+        return (i * 5 + row * 3 + col) % 8;
+    }
+
+    // Writes count rows x cols records to DATASET_PATH and returns the file's bytes
+    std::vector<uint8_t> writeDataset(int count, int rows, int cols)
+    {
+        DatasetWriter writer;
+        Assert::IsTrue(writer.open(DATASET_PATH, rows, cols));
+        std::vector<uint8_t> packed(BoardCodec::packedSize(rows, cols));
+        for (int i = 0; i < count; ++i)
+        {
+            std::vector<std::vector<int>> board(rows, std::vector<int>(cols));
+            for (int r = 0; r < rows; ++r)
+            {
+                for (int c = 0; c < cols; ++c)
+                {
+                    board[r][c] = datasetCell(i, r, c);
+                }
+            }
+            BoardCodec::pack(board, rows, cols, packed.data());
+            PositionMetadata metadata = { 1000 * i, -i, static_cast<int16_t>(30 - i), static_cast<uint8_t>(1 + i % 2), static_cast<uint8_t>(i) };
+            Assert::IsTrue(writer.append(metadata, packed.data()));
+        }
+        Assert::IsTrue(writer.close());
+        return readFile(DATASET_PATH);
+    }
+}
+
+namespace match3test
+{
+	TEST_CLASS(match3test)
+	{
+	public:
+
+        TEST_METHOD(TestClearMatchesAgainstPerCellScan)
+        {
+            std::mt19937 random(2376);
+            for (int i = 0; i < 2000; ++i)
+            {
+                Board board(3 + i % 10, 3 + (i / 10) % 10);
+                randomFill(board, random, 3);
+                Board before = board;
+                int combo = 1 + i % 3;
+
+                std::vector<int> marks;
+                int marked = referenceMarks(board, marks);
+                int points = 0;
+                for (size_t cell = 0; cell < marks.size(); ++cell)
+                {
+                    if (marks[cell]) points += GEM_VALUES[before[0][cell]] * combo;
+                }
+
+                // Every cell forEachRun reports is marked by the per-cell scan, and the other way round
+                std::vector<int> runCells(marks.size(), 0);
+                int runs = Rules::forEachRun(board, [&](int gem, int row, int col, int length, bool horizontal)
+                {
+                    Assert::IsTrue(length >= Match3::MIN_RUN);
+                    for (int k = 0; k < length; ++k)
+                    {
+                        int r = horizontal ? row : row + k;
+                        int c = horizontal ? col + k : col;
+                        Assert::AreEqual(gem, board[r][c]);
+                        runCells[r * board.cols() + c] = 1;
+                    }
+                });
+                Assert::IsTrue(runCells == marks);
+                Assert::AreEqual(marked > 0, runs > 0);
+                Assert::AreEqual(marked > 0, Rules::hasMatches(board));
+
+                Match3::Cleared cleared = Rules::clearMatches(board, combo);
+                Assert::AreEqual(marked, cleared.gems);
+                Assert::AreEqual(points, cleared.points);
+                Assert::AreEqual(marked > 0 ? 1 : 0, cleared.cascades);
+                for (size_t cell = 0; cell < marks.size(); ++cell)
+                {
+                    Assert::AreEqual(marks[cell] ? Match3::EMPTY : before[0][cell], board[0][cell]);
+                }
+            }
+        }
+
+        TEST_METHOD(TestCrossedRunsFormOneGroup)
+        {
+            typedef Match3::Rules<Board, CrossScoring> CrossRules;
+
+            // An L: a red run along the top row and down the left column, sharing the corner
+            Board board;
+            fillWithoutMatches(board);
+            for (int k = 0; k < 3; ++k)
+            {
+                board[0][k] = 1;
+                board[k][0] = 1;
+            }
+            std::vector<Match3::Group> groups;
+            Match3::Cleared cleared = CrossRules::clearMatches(board, 1, 0, [](int, int, int) {},
+                [&groups](const Match3::Group& group) { groups.push_back(group); });
+            Assert::AreEqual(1, static_cast<int>(groups.size()));
+            Assert::AreEqual(5, groups[0].cells);
+            Assert::AreEqual(2, groups[0].runs);
+            Assert::IsFalse(groups[0].crossesMiddle);
+            Assert::AreEqual(0, groups[0].row);
+            Assert::AreEqual(0, groups[0].col);
+            Assert::AreEqual(5, cleared.gems);
+            Assert::AreEqual(300 * 5 * 2, cleared.points); // Paid once for its 5 gems, doubled for crossing
+            Assert::AreEqual(cleared.points, groups[0].points);
+
+            // A T: the column runs down from the middle of the row
+            fillWithoutMatches(board);
+            for (int k = 0; k < 3; ++k)
+            {
+                board[0][k] = 1;
+                board[k][1] = 1;
+            }
+            groups.clear();
+            CrossRules::clearMatches(board, 1, 0, [](int, int, int) {},
+                [&groups](const Match3::Group& group) { groups.push_back(group); });
+            Assert::AreEqual(1, static_cast<int>(groups.size()));
+            Assert::IsTrue(groups[0].crossesMiddle);
+
+            // Two runs that do not cross are two straight groups
+            fillWithoutMatches(board);
+            for (int k = 0; k < 3; ++k)
+            {
+                board[0][k] = 1;
+                board[2 + k][4] = 1;
+            }
+            groups.clear();
+            cleared = CrossRules::clearMatches(board, 1, 0, [](int, int, int) {},
+                [&groups](const Match3::Group& group) { groups.push_back(group); });
+            Assert::AreEqual(2, static_cast<int>(groups.size()));
+            Assert::AreEqual(1, groups[0].runs);
+            Assert::AreEqual(1, groups[1].runs);
+            Assert::AreEqual(300 * 6, cleared.points);
+        }
+
+        TEST_METHOD(TestDropAndRefill)
+        {
+            std::mt19937 random(42);
+            std::uniform_int_distribution<int> cell(0, Match3::GEM_KINDS); // 0 leaves a hole
+            for (int i = 0; i < 500; ++i)
+            {
+                Board board(1 + i % 9, 1 + (i / 9) % 9);
+                for (int r = 0; r < board.rows(); ++r)
+                {
+                    for (int c = 0; c < board.cols(); ++c)
+                    {
+                        board[r][c] = cell(random);
+                    }
+                }
+                Board before = board;
+
+                const int* fall = Rules::drop(board);
+                for (int c = 0; c < board.cols(); ++c)
+                {
+                    // The column's gems keep their order and sit on the bottom, under fall[c] holes
+                    std::vector<int> gems;
+                    for (int r = 0; r < board.rows(); ++r)
+                    {
+                        if (before[r][c] != Match3::EMPTY) gems.push_back(before[r][c]);
+                    }
+                    Assert::AreEqual(board.rows() - static_cast<int>(gems.size()), fall[c]);
+                    for (int r = 0; r < board.rows(); ++r)
+                    {
+                        int expected = r < fall[c] ? Match3::EMPTY : gems[r - fall[c]];
+                        Assert::AreEqual(expected, board[r][c]);
+                    }
+                }
+
+                Board dropped = board;
+                int nextValue = 0;
+                auto nextGem = [&nextValue]() { return nextValue++ % Match3::GEM_KINDS + 1; };
+                int fills = 0;
+                Rules::refill(board, fall, nextGem, [&](int row, int col, int fallCount)
+                {
+                    Assert::IsTrue(row < fall[col]);
+                    Assert::AreEqual(fall[col], fallCount);
+                    fills++;
+                });
+                int holes = 0;
+                for (int r = 0; r < board.rows(); ++r)
+                {
+                    for (int c = 0; c < board.cols(); ++c)
+                    {
+                        Assert::AreNotEqual(Match3::EMPTY, board[r][c]);
+                        if (dropped[r][c] == Match3::EMPTY) holes++;
+                        else Assert::AreEqual(dropped[r][c], board[r][c]);
+                    }
+                }
+                Assert::AreEqual(holes, fills);
+            }
+        }
+
+        TEST_METHOD(TestSwapFormsMatchAndValidMoves)
+        {
+            std::mt19937 random(7);
+            int boardsWithoutMoves = 0;
+            for (int i = 0; i < 3000; ++i)
+            {
+                Board board(3 + i % 6, 3 + (i / 6) % 6);
+                randomFill(board, random, Match3::GEM_KINDS);
+                if (Rules::hasMatches(board)) continue; // The rules only ever see match-free boards
+
+                bool anyMove = false;
+                for (int r = 0; r < board.rows(); ++r)
+                {
+                    for (int c = 0; c < board.cols(); ++c)
+                    {
+                        const int targets[2][2] = { { r, c + 1 }, { r + 1, c } };
+                        for (const auto& target : targets)
+                        {
+                            if (!Rules::inBounds(board, target[0], target[1])) continue;
+                            Board copy = board;
+                            std::swap(copy[r][c], copy[target[0]][target[1]]);
+                            bool matches = Rules::hasMatches(copy);
+                            Assert::AreEqual(matches, Rules::swapFormsMatch(board, r, c, target[0], target[1]));
+                            Assert::AreEqual(matches, Rules::isValidMove(board, r, c, target[0], target[1]));
+                            anyMove = anyMove || matches;
+                        }
+                    }
+                }
+                Assert::AreEqual(anyMove, Rules::hasValidMoves(board));
+                if (!anyMove) boardsWithoutMoves++;
+            }
+            Assert::IsTrue(boardsWithoutMoves > 0); // Both answers of hasValidMoves were checked
+
+            Board board(8, 8);
+            Assert::IsFalse(Rules::isValidMove(board, 0, 0, 1, 1)); // Not adjacent
+            Assert::IsFalse(Rules::isValidMove(board, 0, 7, 0, 8)); // Out of bounds
+        }
+
+        TEST_METHOD(TestParseScoreRules)
+        {
+            Match3::ScoreRules rules = Match3::GemValueScoring::rules();
+            std::string error;
+            std::istringstream good("# tuning\n"
+                "gems = 1 2 3 4 5\n"
+                "runs = 100 150     # longer runs carry the last value\n"
+                "\n"
+                "crosses = 120\n"
+                "cascades = 100 200\n"
+                "combo = 0\n");
+            Assert::IsTrue(Match3::parseScoreRules(good, rules, error));
+            for (int gem = 1; gem <= Match3::GEM_KINDS; ++gem)
+            {
+                Assert::AreEqual(gem, rules.gemValues[gem]);
+            }
+            Assert::AreEqual(100, rules.runPercent[3]);
+            for (int run = 4; run <= Match3::MAX_SCORED_RUN; ++run)
+            {
+                Assert::AreEqual(150, rules.runPercent[run]);
+            }
+            Assert::AreEqual(120, rules.crossPercent);
+            Assert::AreEqual(100, rules.cascadePercent[0]);
+            Assert::AreEqual(200, rules.cascadePercent[Match3::MAX_SCORED_CASCADE - 1]);
+            Assert::AreEqual(0, rules.comboScales);
+
+            // Each bad file names its first bad line and leaves the rules as they were
+            const char* const BAD_FILES[][2] = {
+                { "gems = 1 2 3 4 5\nruns 100\n", "line 2: expected key = values" },
+                { "\n# comment\ncascades = 100 x\n", "line 3: cascades takes whole numbers only" },
+                { "runs =\n", "line 1: runs takes whole numbers only" },
+                { "combo = 0\nruns = -5\n", "line 2: runs cannot be negative" },
+                { "gems = 1 2\n", "line 1: unknown setting or wrong number of values for gems" },
+                { "combo = 2\n", "line 1: unknown setting or wrong number of values for combo" },
+                { "speed = 3\n", "line 1: unknown setting or wrong number of values for speed" },
+            };
+            for (const auto& bad : BAD_FILES)
+            {
+                Match3::ScoreRules kept = Match3::GemValueScoring::rules();
+                std::istringstream in(bad[0]);
+                Assert::IsFalse(Match3::parseScoreRules(in, kept, error));
+                Assert::AreEqual(bad[1], error.c_str());
+                Assert::AreEqual(300, kept.gemValues[1]);
+                Assert::AreEqual(1, kept.comboScales);
+            }
+        }
+
+        TEST_METHOD(TestSwapIndexBestAgainstBruteForce)
+        {
+            std::mt19937 random(2024);
+            std::uniform_int_distribution<int> gemDistribution(1, Match3::GEM_KINDS);
+            auto nextGem = [&]() { return gemDistribution(random); };
+            for (int i = 0; i < 200; ++i)
+            {
+                Board board(4 + i % 6, 4 + (i / 6) % 6);
+                Rules::deal(board, nextGem);
+                Match3::SwapIndex<Board> index;
+                index.resize(board.rows(), board.cols());
+
+                // Play the hinted swap a few times, reporting every changed cell as the games do
+                for (int move = 0; move < 10; ++move)
+                {
+                    Match3::SwapIndex<Board>::Swap hinted;
+                    Match3::SwapIndex<Board>::Swap expected;
+                    bool found = index.best(board, hinted);
+                    Assert::AreEqual(bruteForceBest(board, expected), found);
+                    if (!found) break;
+                    Assert::AreEqual(expected.row1, hinted.row1);
+                    Assert::AreEqual(expected.col1, hinted.col1);
+                    Assert::AreEqual(expected.row2, hinted.row2);
+                    Assert::AreEqual(expected.col2, hinted.col2);
+                    Assert::AreEqual(expected.clears, hinted.clears);
+
+                    std::swap(board[hinted.row1][hinted.col1], board[hinted.row2][hinted.col2]);
+                    index.cellChanged(hinted.row1, hinted.col1);
+                    index.cellChanged(hinted.row2, hinted.col2);
+                    auto changed = [&index](int row, int col, int) { index.cellChanged(row, col); };
+                    while (Rules::clearMatches(board, 1, 0, changed).gems > 0)
+                    {
+                        const int* fall = Rules::drop(board, [&index](int fromRow, int toRow, int col)
+                        {
+                            index.cellChanged(fromRow, col);
+                            index.cellChanged(toRow, col);
+                        });
+                        Rules::refill(board, fall, nextGem, changed);
+                    }
+                }
+            }
+        }
+
+        TEST_METHOD(TestBoardCodecRoundTrip)
+        {
+            Assert::AreEqual(static_cast<size_t>(24), BoardCodec::packedSize(8, 8));
+            Assert::AreEqual(static_cast<size_t>(1), BoardCodec::packedSize(1, 1));
+            Assert::AreEqual(static_cast<size_t>(3), BoardCodec::packedSize(1, 8));
+            Assert::AreEqual(static_cast<size_t>(4), BoardCodec::packedSize(3, 3)); // 27 bits
+
+            std::mt19937 random(30);
+            std::uniform_int_distribution<int> value(0, 7);
+            for (int rows = 1; rows <= 10; ++rows)
+            {
+                for (int cols = 1; cols <= 10; ++cols)
+                {
+                    std::vector<std::vector<int>> board(rows, std::vector<int>(cols));
+                    for (auto& row : board)
+                    {
+                        for (int& cell : row) cell = value(random);
+                    }
+                    board[0][0] = 7; // All three bits set in the first and last cells
+                    board[rows - 1][cols - 1] = 7;
+
+                    // One guard byte past the end must never be written
+                    std::vector<uint8_t> packed(BoardCodec::packedSize(rows, cols) + 1, 0xAB);
+                    BoardCodec::pack(board, rows, cols, packed.data());
+                    Assert::AreEqual(static_cast<uint8_t>(0xAB), packed.back());
+
+                    std::vector<std::vector<int>> unpacked;
+                    BoardCodec::unpack(packed.data(), rows, cols, unpacked);
+                    Assert::IsTrue(unpacked == board);
+                    for (int r = 0; r < rows; ++r)
+                    {
+                        for (int c = 0; c < cols; ++c)
+                        {
+                            size_t index = static_cast<size_t>(r) * cols + c;
+                            Assert::AreEqual(static_cast<unsigned int>(board[r][c]), BoardCodec::getCell(packed.data(), index));
+                        }
+                    }
+
+                    // setCell changes its own cell only
+                    for (int r = 0; r < rows; ++r)
+                    {
+                        for (int c = 0; c < cols; ++c)
+                        {
+                            board[r][c] = 7 - board[r][c];
+                            BoardCodec::setCell(packed.data(), static_cast<size_t>(r) * cols + c, static_cast<unsigned int>(board[r][c]));
+                        }
+                    }
+                    BoardCodec::unpack(packed.data(), rows, cols, unpacked);
+                    Assert::IsTrue(unpacked == board);
+                    Assert::AreEqual(static_cast<uint8_t>(0xAB), packed.back());
+                }
+            }
+        }
+
+        TEST_METHOD(TestDatasetRoundTrip)
+        {
+            const int COUNT = 20;
+            const int ROWS = 8;
+            const int COLS = 7; // Not a multiple of 8 bits per row
+            std::vector<uint8_t> bytes = writeDataset(COUNT, ROWS, COLS);
+            Assert::AreEqual(sizeof(DatasetHeader) + COUNT * (sizeof(PositionMetadata) + BoardCodec::packedSize(ROWS, COLS)), bytes.size());
+
+            MappedDataset dataset;
+            Assert::IsTrue(dataset.open(DATASET_PATH));
+            Assert::AreEqual(COUNT, static_cast<int>(dataset.count()));
+            Assert::AreEqual(ROWS, dataset.rows());
+            Assert::AreEqual(COLS, dataset.cols());
+            for (int i = 0; i < COUNT; ++i)
+            {
+                PositionMetadata metadata = dataset.metadata(i);
+                Assert::AreEqual(1000 * i, static_cast<int>(metadata.player1Score));
+                Assert::AreEqual(-i, static_cast<int>(metadata.player2Score));
+                Assert::AreEqual(30 - i, static_cast<int>(metadata.movesLeft));
+                Assert::AreEqual(1 + i % 2, static_cast<int>(metadata.currentPlayer));
+                Assert::AreEqual(i, static_cast<int>(metadata.flags));
+
+                std::vector<std::vector<int>> board;
+                BoardCodec::unpack(dataset.board(i), ROWS, COLS, board);
+                for (int r = 0; r < ROWS; ++r)
+                {
+                    for (int c = 0; c < COLS; ++c)
+                    {
+                        Assert::AreEqual(datasetCell(i, r, c), board[r][c]);
+                        Assert::AreEqual(static_cast<unsigned int>(datasetCell(i, r, c)), dataset.gem(i, r, c));
+                    }
+                }
+            }
+            dataset.close();
+
+            // A dataset with no records is still a dataset
+            writeDataset(0, ROWS, COLS);
+            Assert::IsTrue(dataset.open(DATASET_PATH));
+            Assert::AreEqual(0, static_cast<int>(dataset.count()));
+            dataset.close();
+            std::remove(DATASET_PATH);
+        }
+
+        TEST_METHOD(TestDatasetRejectsDamagedFiles)
+        {
+            const std::vector<uint8_t> good = writeDataset(5, 8, 8);
+            MappedDataset dataset;
+            Assert::IsTrue(dataset.open(DATASET_PATH));
+            dataset.close();
+
+            std::vector<std::vector<uint8_t>> damaged;
+            damaged.push_back(std::vector<uint8_t>(good.begin(), good.end() - 1)); // Last record cut short
+            damaged.push_back(std::vector<uint8_t>(good.begin(), good.begin() + sizeof(DatasetHeader) - 1)); // Header cut short
+            damaged.push_back(std::vector<uint8_t>(good.begin(), good.begin() + 4)); // Magic only
+            damaged.push_back(std::vector<uint8_t>()); // Empty file
+            damaged.push_back(good);
+            damaged.back()[0] = 'X'; // Bad magic
+            damaged.push_back(good);
+            damaged.back()[offsetof(DatasetHeader, version)] = DATASET_VERSION + 1;
+            damaged.push_back(good);
+            damaged.back()[offsetof(DatasetHeader, recordSize)] += 1;
+            damaged.push_back(good);
+            damaged.back()[offsetof(DatasetHeader, cols)] = 9; // Boards that no longer fit recordSize
+            damaged.push_back(good);
+            damaged.back()[offsetof(DatasetHeader, count)] = 6; // More records than the file holds
+            for (size_t i = 0; i < damaged.size(); ++i)
+            {
+                writeFile(DATASET_PATH, damaged[i]);
+                Assert::IsFalse(dataset.open(DATASET_PATH));
+                Assert::AreEqual(0, static_cast<int>(dataset.count()));
+                Assert::AreEqual(0, dataset.rows());
+            }
+
+            std::remove(DATASET_PATH);
+            Assert::IsFalse(dataset.open(DATASET_PATH)); // Missing file
+            Assert::IsFalse(dataset.open(""));
+        }
+
+	};
+}